@@ -5,11 +5,30 @@
 #include <vector>
 #include <algorithm>
 #include <queue>
+#include <deque>
 #include <list>
 #include <iomanip>
 #include <cmath>
 #include <unordered_map>
+#include <map>
 #include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <filesystem>
+#include <new>
+#include <functional>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
 
 struct Management_Infos // infos gerais da simulação
 {
@@ -79,120 +98,681 @@ struct Simulation_data
     std::vector<Process> processes;
 };
 
+// leitor incremental do arquivo de entrada: cabeçalho e dispositivos na abertura,
+// processos sob demanda em blocos
+class Workload_reader
+{
+private:
+    std::ifstream file;
+    Management_Infos management_infos;
+    std::vector<Device> devices;
+
+    static Management_Infos parse_header(const std::string &line)
+    {
+        Management_Infos infos;
+        std::stringstream ss(line);
+        std::string token;
+
+        std::getline(ss, infos.scheduling_algorithm, '|');
+        std::getline(ss, token, '|');
+        infos.cpu_fraction = std::stoi(token);
+        std::getline(ss, infos.memory_policy, '|');
+        std::getline(ss, token, '|');
+        infos.memory_size = std::stoi(token);
+        std::getline(ss, token, '|');
+        infos.page_size = std::stoi(token);
+        std::getline(ss, token, '|');
+        infos.allocation_percentage = std::stod(token);
+        std::getline(ss, token);
+        infos.num_devices = std::stoi(token);
+        return infos;
+    }
+
+    static Device parse_device(const std::string &line)
+    {
+        Device device;
+        std::stringstream ss(line);
+        std::string token;
+
+        std::getline(ss, device.name_id, '|');
+        std::getline(ss, token, '|');
+        device.simultaneous_uses = std::stoi(token);
+        std::getline(ss, token);
+        device.operation_time = std::stoi(token);
+        return device;
+    }
+
+    static Process parse_process(const std::string &line)
+    {
+        Process proc;
+        std::stringstream ss(line);
+        std::string token;
+
+        std::getline(ss, token, '|');
+        proc.creation_time = std::stoi(token);
+        std::getline(ss, token, '|');
+        proc.pid = std::stoi(token);
+        std::getline(ss, token, '|');
+        proc.execution_time = std::stoi(token);
+        proc.remaining_time = proc.execution_time;
+        std::getline(ss, token, '|');
+        proc.priority = std::stoi(token);
+        std::getline(ss, token, '|');
+        proc.memory_needed = std::stoi(token);
+
+        std::getline(ss, token, '|');
+        std::stringstream pages_ss(token);
+        int page;
+        while (pages_ss >> page)
+            proc.page_sequence.push_back(page);
+
+        if (std::getline(ss, token))
+            proc.io_chance = std::stoi(token);
+        else
+            proc.io_chance = 0;
+        return proc;
+    }
+
+public:
+    explicit Workload_reader(const std::string &filename) : file(filename)
+    {
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Erro ao abrir o arquivo: " + filename);
+        }
+
+        std::string line;
+        int line_count = 0;
+        int devices_read = 0;
+
+        while (line_count == 0 || devices_read < management_infos.num_devices)
+        {
+            if (!std::getline(file, line))
+                break;
+            if (line.empty())
+                continue;
+            line_count++;
+
+            if (line_count == 1)
+                management_infos = parse_header(line);
+            else
+            {
+                devices.push_back(parse_device(line));
+                devices_read++;
+            }
+        }
+    }
+
+    const Management_Infos &get_management_infos() const { return management_infos; }
+    const std::vector<Device> &get_devices() const { return devices; }
+
+    // acrescenta até max_count processos; retorna quantos leu (0 no fim do arquivo)
+    size_t read_processes(std::vector<Process> &processes, size_t max_count)
+    {
+        std::string line;
+        size_t count = 0;
+        while (count < max_count && std::getline(file, line))
+        {
+            if (line.empty())
+                continue;
+            processes.push_back(parse_process(line));
+            count++;
+        }
+        return count;
+    }
+};
+
 Simulation_data read_file(const std::string &filename)
 {
     Simulation_data simData;
+    Workload_reader reader(filename);
 
-    std::ifstream file(filename);
-    if (!file.is_open())
+    simData.management_infos = reader.get_management_infos();
+    simData.devices = reader.get_devices();
+    while (reader.read_processes(simData.processes, SIZE_MAX) > 0)
     {
-        throw std::runtime_error("Erro ao abrir o arquivo: " + filename);
     }
 
-    std::string line;
-    int line_count = 0;
-    int devices_read = 0;
+    simData.management_infos.num_processes = (int)simData.processes.size();
+    return simData;
+}
+
+// gerador pseudoaleatório (splitmix64) com estado pequeno para caber no checkpoint
+struct Sim_random
+{
+    uint64_t state;
+
+    explicit Sim_random(uint64_t seed = 0) : state(seed) {}
 
-    while (std::getline(file, line))
+    uint32_t next()
     {
-        if (line.empty())
-            continue;
-        line_count++;
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return (uint32_t)((z ^ (z >> 31)) >> 32);
+    }
+};
+
+// mistura um valor num hash de 64 bits
+inline uint64_t hash_mix(uint64_t h, uint64_t value)
+{
+    h ^= value + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    return h * 0xFF51AFD7ED558CCDull;
+}
+
+static uint64_t hash_text(uint64_t h, const std::string &text)
+{
+    h = hash_mix(h, text.size());
+    for (unsigned char c : text)
+        h = hash_mix(h, c);
+    return h;
+}
+
+// identifica o arquivo de entrada para não retomar checkpoint de outra carga;
+// cobre todos os campos lidos, já que qualquer um deles muda o resultado
+uint64_t workload_fingerprint(const Simulation_data &data)
+{
+    const Management_Infos &infos = data.management_infos;
+    uint64_t allocation_bits;
+    std::memcpy(&allocation_bits, &infos.allocation_percentage, sizeof(allocation_bits));
+
+    uint64_t h = hash_text(0, infos.scheduling_algorithm);
+    h = hash_mix(h, (uint64_t)infos.cpu_fraction);
+    h = hash_text(h, infos.memory_policy);
+    h = hash_mix(h, (uint64_t)infos.memory_size);
+    h = hash_mix(h, (uint64_t)infos.page_size);
+    h = hash_mix(h, allocation_bits);
+    h = hash_mix(h, data.devices.size());
+    h = hash_mix(h, data.processes.size());
+
+    for (const auto &dev : data.devices)
+    {
+        h = hash_text(h, dev.name_id);
+        h = hash_mix(h, (uint64_t)dev.simultaneous_uses);
+        h = hash_mix(h, (uint64_t)dev.operation_time);
+    }
+    for (const auto &proc : data.processes)
+    {
+        h = hash_mix(h, (uint64_t)proc.pid);
+        h = hash_mix(h, (uint64_t)proc.creation_time);
+        h = hash_mix(h, (uint64_t)proc.execution_time);
+        h = hash_mix(h, (uint64_t)proc.priority);
+        h = hash_mix(h, (uint64_t)proc.memory_needed);
+        h = hash_mix(h, (uint64_t)proc.io_chance);
+        h = hash_mix(h, proc.page_sequence.size());
+        for (int page : proc.page_sequence)
+            h = hash_mix(h, (uint64_t)(uint32_t)page);
+    }
+    return h;
+}
+
+// escreve inteiros em formato binário compacto (varint)
+class Binary_writer
+{
+private:
+    std::string buffer;
 
-        if (line_count == 1)
+public:
+    void put_uint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((char)value);
+    }
+
+    // zigzag para números negativos ocuparem poucos bytes
+    void put_int(long long value)
+    {
+        put_uint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    void put_string(const std::string &value)
+    {
+        put_uint(value.size());
+        buffer += value;
+    }
+
+    const std::string &data() const { return buffer; }
+};
+
+class Binary_reader
+{
+private:
+    std::string buffer;
+    size_t pos;
+
+public:
+    Binary_reader(const std::string &bytes = "", size_t start = 0) : buffer(bytes), pos(start) {}
+
+    uint64_t get_uint()
+    {
+        uint64_t value = 0;
+        int shift = 0;
+        while (true)
         {
-            std::stringstream ss(line);
-            std::string token;
+            if (pos >= buffer.size() || shift > 63)
+                throw std::runtime_error("Checkpoint truncado ou corrompido");
+            unsigned char byte = (unsigned char)buffer[pos++];
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+            shift += 7;
+        }
+    }
+
+    long long get_int()
+    {
+        uint64_t raw = get_uint();
+        return (long long)(raw >> 1) ^ -(long long)(raw & 1);
+    }
+
+    std::string get_string()
+    {
+        uint64_t len = get_uint();
+        if (len > buffer.size() - pos)
+            throw std::runtime_error("Checkpoint truncado ou corrompido");
+        std::string value = buffer.substr(pos, len);
+        pos += len;
+        return value;
+    }
+};
+
+// fase em que a simulação estava quando o checkpoint foi gravado
+enum Checkpoint_phase
+{
+    CHECKPOINT_SCHEDULER = 0,
+    CHECKPOINT_MEMORY = 1
+};
+
+static volatile std::sig_atomic_t checkpoint_signal = 0;
+
+// SIGUSR1 pede um checkpoint no próximo ponto seguro
+void request_checkpoint(int)
+{
+    checkpoint_signal = 1;
+}
+
+// grava checkpoints periódicos ou sob demanda e lê o checkpoint para retomar
+class Checkpoint_manager
+{
+private:
+    std::string path;
+    uint64_t fingerprint;
+    int interval_seconds;
+    std::chrono::steady_clock::time_point last_write;
+
+    static const uint64_t VERSION = 2;
+
+public:
+    Checkpoint_manager(const std::string &file_path, uint64_t workload_id, int interval)
+        : path(file_path), fingerprint(workload_id), interval_seconds(interval),
+          last_write(std::chrono::steady_clock::now()) {}
+
+    // diz se já é hora de gravar (intervalo vencido ou sinal recebido)
+    bool due() const
+    {
+        if (checkpoint_signal)
+            return true;
+        auto elapsed = std::chrono::steady_clock::now() - last_write;
+        return elapsed >= std::chrono::seconds(interval_seconds);
+    }
+
+    void save(Checkpoint_phase phase, const Binary_writer &state)
+    {
+        Binary_writer header;
+        header.put_string("IOSIMCKP");
+        header.put_uint(VERSION);
+        header.put_uint(fingerprint);
+        header.put_uint((uint64_t)phase);
+
+        // grava em arquivo temporário e renomeia para nunca deixar um checkpoint pela metade
+        std::string tmp_path = path + ".tmp";
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw std::runtime_error("Erro ao gravar checkpoint: " + tmp_path);
+        file.write(header.data().data(), (std::streamsize)header.data().size());
+        file.write(state.data().data(), (std::streamsize)state.data().size());
+        file.close();
+        if (!file || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+            throw std::runtime_error("Erro ao gravar checkpoint: " + path);
+
+        last_write = std::chrono::steady_clock::now();
+        checkpoint_signal = 0;
+        std::cerr << "[CHECKPOINT] estado salvo em '" << path << "'\n";
+    }
+
+    // abre o checkpoint e devolve o leitor posicionado no estado da fase
+    static Binary_reader load(const std::string &file_path, uint64_t workload_id, Checkpoint_phase &phase)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Erro ao abrir o checkpoint: " + file_path);
+        std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Binary_reader reader(bytes);
+        if (reader.get_string() != "IOSIMCKP" || reader.get_uint() != VERSION)
+            throw std::runtime_error("Arquivo nao e um checkpoint valido: " + file_path);
+        if (reader.get_uint() != workload_id)
+            throw std::runtime_error("Checkpoint pertence a outro arquivo de entrada: " + file_path);
+
+        uint64_t raw_phase = reader.get_uint();
+        if (raw_phase > CHECKPOINT_MEMORY)
+            throw std::runtime_error("Checkpoint truncado ou corrompido");
+        phase = (Checkpoint_phase)raw_phase;
+        return reader;
+    }
+};
+
+// tipos de evento gravados no índice de replay
+enum Replay_event_type
+{
+    EVENT_READY = 0,    // entrou na fila de prontos
+    EVENT_DISPATCH = 1, // ganhou a CPU
+    EVENT_IO_REQUEST = 2,
+    EVENT_IO_WAIT = 3,  // foi para a fila de espera do dispositivo
+    EVENT_IO_START = 4,
+    EVENT_IO_END = 5,
+    EVENT_FINISH = 6,
+    EVENT_STEP = 7 // fim de um passo do escalonador
+};
+
+// registro de tamanho fixo para permitir acesso direto no arquivo
+struct Replay_event
+{
+    int32_t time;
+    int32_t pid;
+    int16_t device;
+    uint8_t type;
+    uint8_t unused;
+};
+
+struct Replay_snapshot
+{
+    int time;
+    uint64_t event_index; // primeiro evento depois do snapshot
+    uint64_t offset;      // posição do estado serializado no arquivo
+    uint64_t size;
+};
+
+static const char REPLAY_MAGIC[8] = {'I', 'O', 'S', 'I', 'M', 'I', 'D', 'X'};
+static const char REPLAY_END_MAGIC[8] = {'I', 'O', 'S', 'I', 'M', 'E', 'N', 'D'};
+static const uint64_t REPLAY_BLOCK = 4096;            // eventos por bloco do log
+static const uint64_t REPLAY_SORT_EVENTS = 1u << 20; // eventos em memória por passada da cópia por pid
+
+// registros gravados em sequência conforme a simulação anda
+enum Replay_record_tag
+{
+    RECORD_EVENTS = 'E',   // u32 quantidade + eventos (blocos cheios, exceto o último)
+    RECORD_SNAPSHOT = 'S', // i32 tempo, u64 evento, u64 tamanho + estado
+    RECORD_BY_PID = 'P'    // u64 quantidade + eventos agrupados por pid (só no fim)
+};
+
+// grava o índice de replay: snapshots esparsos do escalonador e log de eventos entre eles
+//
+// layout: magic | dados estáticos | registros E/S na ordem da simulação |
+//         P com os eventos agrupados por pid | tabelas (varint) | offset das tabelas | magic final
+//
+// Eventos e snapshots vão para o disco enquanto a simulação roda, então a memória não cresce
+// com o tamanho da execução; se ela for interrompida, a consulta reconstrói as tabelas
+// percorrendo os registros.
+class Replay_recorder
+{
+private:
+    std::string path;
+    std::ofstream file;
+    int snapshot_every;
+    long long steps;
+    std::vector<Replay_event> pending; // bloco ainda não gravado
+    uint64_t events_written;
+    std::vector<uint64_t> block_offsets; // posição do primeiro evento de cada bloco
+    std::vector<Replay_snapshot> snapshots;
+
+    void write_raw(const void *bytes, size_t size)
+    {
+        file.write((const char *)bytes, (std::streamsize)size);
+    }
+
+    void write_tag(Replay_record_tag tag)
+    {
+        char byte = (char)tag;
+        write_raw(&byte, 1);
+    }
+
+    void flush_events()
+    {
+        if (pending.empty())
+            return;
+        uint32_t count = (uint32_t)pending.size();
+        write_tag(RECORD_EVENTS);
+        write_raw(&count, sizeof(count));
+        block_offsets.push_back((uint64_t)file.tellp());
+        write_raw(pending.data(), pending.size() * sizeof(Replay_event));
+        file.flush();
+        events_written += count;
+        pending.clear();
+    }
 
-            std::getline(ss, simData.management_infos.scheduling_algorithm, '|');
-            std::getline(ss, token, '|');
-            simData.management_infos.cpu_fraction = std::stoi(token);
-            std::getline(ss, simData.management_infos.memory_policy, '|');
-            std::getline(ss, token, '|');
-            simData.management_infos.memory_size = std::stoi(token);
-            std::getline(ss, token, '|');
-            simData.management_infos.page_size = std::stoi(token);
-            std::getline(ss, token, '|');
-            simData.management_infos.allocation_percentage = std::stod(token);
-            std::getline(ss, token);
-            simData.management_infos.num_devices = std::stoi(token);
+    // percorre o log já gravado bloco a bloco
+    template <typename Visit>
+    void for_each_event(std::ifstream &log, std::vector<Replay_event> &buffer, Visit visit)
+    {
+        for (size_t block = 0; block < block_offsets.size(); ++block)
+        {
+            uint64_t count = std::min(REPLAY_BLOCK, events_written - block * REPLAY_BLOCK);
+            buffer.resize(count);
+            log.seekg((std::streamoff)block_offsets[block]);
+            log.read((char *)buffer.data(), (std::streamsize)(count * sizeof(Replay_event)));
+            if (!log)
+                throw std::runtime_error("Erro ao reler o indice de replay: " + path);
+            for (const Replay_event &ev : buffer)
+                visit(ev);
         }
+    }
 
-        else if (devices_read < simData.management_infos.num_devices)
+public:
+    Replay_recorder(const std::string &file_path, const Simulation_data &data, int every)
+        : path(file_path), file(file_path, std::ios::binary | std::ios::trunc),
+          snapshot_every(every > 0 ? every : 1), steps(0), events_written(0)
+    {
+        if (!file.is_open())
+            throw std::runtime_error("Erro ao criar o indice de replay: " + file_path);
+        pending.reserve(REPLAY_BLOCK);
+
+        // guarda a parte estática da carga para a consulta não depender do arquivo de entrada
+        const Management_Infos &infos = data.management_infos;
+        Binary_writer header;
+        header.put_string(infos.scheduling_algorithm);
+        header.put_int(infos.cpu_fraction);
+        header.put_string(infos.memory_policy);
+        header.put_int(infos.memory_size);
+        header.put_int(infos.page_size);
+        header.put_uint(data.devices.size());
+        for (const auto &dev : data.devices)
+        {
+            header.put_string(dev.name_id);
+            header.put_int(dev.simultaneous_uses);
+            header.put_int(dev.operation_time);
+        }
+        header.put_uint(data.processes.size());
+        for (const auto &proc : data.processes)
         {
-            Device device;
-            std::stringstream ss(line);
-            std::string token;
+            header.put_int(proc.pid);
+            header.put_int(proc.creation_time);
+            header.put_int(proc.execution_time);
+            header.put_int(proc.priority);
+            header.put_int(proc.memory_needed);
+            header.put_int(proc.io_chance);
+        }
+
+        write_raw(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+        uint64_t header_size = header.data().size();
+        write_raw(&header_size, sizeof(header_size));
+        write_raw(header.data().data(), header.data().size());
+    }
+
+    void record(int time, Replay_event_type type, int pid, int device = -1)
+    {
+        pending.push_back({time, pid, (int16_t)device, (uint8_t)type, 0});
+        if (pending.size() == REPLAY_BLOCK)
+            flush_events();
+    }
+
+    // conta um passo e diz se é hora de um novo snapshot
+    bool step_done(int time)
+    {
+        record(time, EVENT_STEP, -1);
+        return ++steps % snapshot_every == 0;
+    }
 
-            std::getline(ss, device.name_id, '|');
-            std::getline(ss, token, '|');
-            device.simultaneous_uses = std::stoi(token);
-            std::getline(ss, token);
-            device.operation_time = std::stoi(token);
+    void add_snapshot(int time, const Binary_writer &state)
+    {
+        int32_t snapshot_time = time;
+        uint64_t event_index = events_written + pending.size();
+        uint64_t size = state.data().size();
+        write_tag(RECORD_SNAPSHOT);
+        write_raw(&snapshot_time, sizeof(snapshot_time));
+        write_raw(&event_index, sizeof(event_index));
+        write_raw(&size, sizeof(size));
+        uint64_t offset = (uint64_t)file.tellp();
+        write_raw(state.data().data(), state.data().size());
+        file.flush();
+        snapshots.push_back({time, event_index, offset, size});
+    }
 
-            simData.devices.push_back(device);
-            devices_read++;
+    void finish()
+    {
+        flush_events();
+
+        // cópia dos eventos agrupada por pid responde o histórico com uma leitura contínua;
+        // montada relendo o log em passadas que cabem em REPLAY_SORT_EVENTS
+        std::ifstream log(path, std::ios::binary);
+        if (!log.is_open())
+            throw std::runtime_error("Erro ao reler o indice de replay: " + path);
+        std::vector<Replay_event> buffer;
+
+        std::unordered_map<int, uint64_t> per_pid;
+        for_each_event(log, buffer, [&per_pid](const Replay_event &ev)
+                       {
+            if (ev.type != EVENT_STEP)
+                per_pid[ev.pid]++; });
+        std::vector<std::pair<int, uint64_t>> counts(per_pid.begin(), per_pid.end());
+        std::sort(counts.begin(), counts.end());
+
+        uint64_t by_pid_count = 0;
+        for (const auto &entry : counts)
+            by_pid_count += entry.second;
+        write_tag(RECORD_BY_PID);
+        write_raw(&by_pid_count, sizeof(by_pid_count));
+        uint64_t by_pid_offset = (uint64_t)file.tellp();
+
+        std::vector<std::pair<int, uint64_t>> pid_ranges; // pid, primeiro evento do pid
+        std::vector<Replay_event> group;
+        uint64_t position = 0;
+        for (size_t first = 0; first < counts.size();)
+        {
+            size_t last = first;
+            uint64_t selected = 0;
+            while (last < counts.size() && (last == first || selected + counts[last].second <= REPLAY_SORT_EVENTS))
+                selected += counts[last++].second;
+
+            int low = counts[first].first, high = counts[last - 1].first;
+            group.clear();
+            for_each_event(log, buffer, [&group, low, high](const Replay_event &ev)
+                           {
+                if (ev.type != EVENT_STEP && ev.pid >= low && ev.pid <= high)
+                    group.push_back(ev); });
+            std::stable_sort(group.begin(), group.end(), [](const Replay_event &a, const Replay_event &b)
+                             { return a.pid < b.pid; });
+
+            for (size_t k = first; k < last; ++k)
+            {
+                pid_ranges.push_back({counts[k].first, position});
+                position += counts[k].second;
+            }
+            write_raw(group.data(), group.size() * sizeof(Replay_event));
+            first = last;
         }
 
-        else
+        Binary_writer tables;
+        tables.put_uint(events_written);
+        tables.put_uint(block_offsets.size());
+        for (uint64_t offset : block_offsets)
+            tables.put_uint(offset);
+        tables.put_uint(by_pid_offset);
+        tables.put_uint(by_pid_count);
+        tables.put_uint(pid_ranges.size());
+        for (const auto &range : pid_ranges)
         {
-            Process proc;
-            std::stringstream ss(line);
-            std::string token;
-
-            std::getline(ss, token, '|');
-            proc.creation_time = std::stoi(token);
-            std::getline(ss, token, '|');
-            proc.pid = std::stoi(token);
-            std::getline(ss, token, '|');
-            proc.execution_time = std::stoi(token);
-            proc.remaining_time = proc.execution_time;
-            std::getline(ss, token, '|');
-            proc.priority = std::stoi(token);
-            std::getline(ss, token, '|');
-            proc.memory_needed = std::stoi(token);
-
-            std::getline(ss, token, '|');
-            std::stringstream pages_ss(token);
-            int page;
-            while (pages_ss >> page)
-                proc.page_sequence.push_back(page);
-
-            if (std::getline(ss, token))
-                proc.io_chance = std::stoi(token);
-            else
-                proc.io_chance = 0;
+            tables.put_int(range.first);
+            tables.put_uint(range.second);
+        }
 
-            simData.processes.push_back(proc);
+        tables.put_uint(snapshots.size());
+        for (const auto &snap : snapshots)
+        {
+            tables.put_int(snap.time);
+            tables.put_uint(snap.event_index);
+            tables.put_uint(snap.offset);
+            tables.put_uint(snap.size);
         }
+
+        uint64_t tables_offset = (uint64_t)file.tellp();
+        write_raw(tables.data().data(), tables.data().size());
+        write_raw(&tables_offset, sizeof(tables_offset));
+        write_raw(REPLAY_END_MAGIC, sizeof(REPLAY_END_MAGIC));
+        file.close();
+        if (!file)
+            throw std::runtime_error("Erro ao gravar o indice de replay: " + path);
+
+        std::cerr << "[REPLAY] indice com " << events_written << " eventos e "
+                  << snapshots.size() << " snapshots gravado em '" << path << "'\n";
     }
+};
 
-    simData.management_infos.num_processes = (int)simData.processes.size();
-    file.close();
-    return simData;
-}
+// níveis de log resolvidos em tempo de compilação: no silencioso as mensagens somem do código
+struct Log_verbose
+{
+    static const bool enabled = true;
+};
+
+struct Log_quiet
+{
+    static const bool enabled = false;
+};
 
 // classe que gerencia as entradas e saídas
+template <typename Log>
 class IOManager
 {
 private:
     std::vector<Device> *devices_list; // lista de dispositivos
     std::vector<Process *> *blocked_list; // lista de processos bloqueados
+    Sim_random random; // sorteios de E/S, semente fixa torna a simulação reproduzível
+    std::ostream *log;
+    Replay_recorder *recorder;
 
 public:
-    IOManager(std::vector<Device> *devices_list, std::vector<Process *> *blocked_list)
+    IOManager(std::vector<Device> *devices_list, std::vector<Process *> *blocked_list, uint64_t seed)
+        : random(seed), log(&std::cout), recorder(nullptr)
     {
         this->devices_list = devices_list;
         this->blocked_list = blocked_list;
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
     }
 
+    uint64_t get_random_state() const { return random.state; }
+    void set_random_state(uint64_t state) { random.state = state; }
+    void set_log(std::ostream *stream) { log = stream; }
+    void set_recorder(Replay_recorder *replay) { recorder = replay; }
+
     // sorteio que decide se o processo vai fazer entrada ou saída
     bool request_io(const Process &process)
     {
         if (process.remaining_time <= 0 || process.is_finished) // impede entrada e saída se o processo tiver acabado
             return false;
-        int chance = std::rand() % 100;
+        int chance = (int)(random.next() % 100);
         return chance < process.io_chance;
     }
 
@@ -201,7 +781,7 @@ public:
     {
         if (slice_used <= 1)
             return 1;
-        return 1 + (std::rand() % slice_used);
+        return 1 + (int)(random.next() % (uint32_t)slice_used);
     }
 
     // escolhe um dispositivo aleatoriamente 
@@ -209,7 +789,7 @@ public:
     {
         if (devices_list->empty())
             return -1;
-        return std::rand() % devices_list->size();
+        return (int)(random.next() % devices_list->size());
     }
 
     // gerencia a entrada/saída de um processo
@@ -261,14 +841,22 @@ public:
             process.is_using_io = false;
         }
 
+        if (recorder)
+        {
+            recorder->record(process.io_start_time, EVENT_IO_REQUEST, process.pid, device_index);
+            recorder->record(process.io_start_time, process.is_using_io ? EVENT_IO_START : EVENT_IO_WAIT,
+                             process.pid, device_index);
+        }
+
         // evitar duplicidade na lista de bloqueados
         auto already = std::find(blocked_list->begin(), blocked_list->end(), &process);
         if (already == blocked_list->end())
             blocked_list->push_back(&process);
 
-        std::cout << "[E/S] PID " << process.pid
-                  << " requisitou E/S no dispositivo '" << device.name_id
-                  << "' (ficou bloqueado em t=" << process.io_start_time << ")\n";
+        if (Log::enabled)
+            *log << "[E/S] PID " << process.pid
+                 << " requisitou E/S no dispositivo '" << device.name_id
+                 << "' (ficou bloqueado em t=" << process.io_start_time << ")\n";
 
         return moment_to_request;
     }
@@ -276,8 +864,9 @@ public:
     // atualiza o estado dos dispositivos e processos bloqueados
     void update_devices(int global_time, std::vector<Process> &processes_list)
     {
-        for (auto &device : *devices_list)
+        for (size_t device_index = 0; device_index < devices_list->size(); ++device_index)
         {
+            Device &device = (*devices_list)[device_index];
             // verifica processos que estão usando o dispositivo e libera os que concluíram
             for (auto it = device.processes_using_devices.begin();
                  it != device.processes_using_devices.end();)
@@ -298,10 +887,13 @@ public:
                         it_proc->is_using_io = false;
                         it_proc->io_end_time = global_time;
                         it_proc->total_io_time += device.operation_time;
+                        if (recorder)
+                            recorder->record(global_time, EVENT_IO_END, pid, (int)device_index);
 
-                        std::cout << "[E/S] PID " << it_proc->pid
-                                  << " terminou uso de " << device.name_id
-                                  << " em t=" << global_time << "\n";
+                        if (Log::enabled)
+                            *log << "[E/S] PID " << it_proc->pid
+                                 << " terminou uso de " << device.name_id
+                                 << " em t=" << global_time << "\n";
 
                         // remove pid da lista de processos usando o dispositivo
                         it = device.processes_using_devices.erase(it);
@@ -328,9 +920,12 @@ public:
                     it_proc->is_using_io = true;
                     it_proc->is_blocked = true;
                     it_proc->io_start_time = global_time; 
-                    std::cout << "[E/S] PID " << it_proc->pid
-                              << " começou uso de " << device.name_id
-                              << " em t=" << global_time << "\n";
+                    if (recorder)
+                        recorder->record(global_time, EVENT_IO_START, next_pid, (int)device_index);
+                    if (Log::enabled)
+                        *log << "[E/S] PID " << it_proc->pid
+                             << " começou uso de " << device.name_id
+                             << " em t=" << global_time << "\n";
                 }
             }
 
@@ -340,104 +935,379 @@ public:
 };
 
 
-class RoundRobinScheduler
+// histograma log-linear no estilo HDR: valores até 127 são exatos e acima disso cada
+// potência de dois tem 64 faixas (erro relativo < 1,6%). O tamanho é fixo e dois
+// histogramas se combinam somando as contagens.
+class Latency_histogram
 {
+public:
+    static const int LINEAR_LIMIT = 128;
+    static const int SUB_BUCKETS = 64;
+    static const int BUCKETS = LINEAR_LIMIT + 24 * SUB_BUCKETS; // cobre até INT32_MAX
+
 private:
-    Management_Infos management_infos;
-    std::vector<Device> devices_list;
-    std::vector<Process> processes_list;
-    std::queue<Process *> ready_queue; // processos em estado de pronto
-    std::vector<Process> finished_list; // processos finalizados
-    std::vector<Process *> blocked_list; // processos em estado de bloqueado
-    IOManager *io_manager;
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    long long sum;
+    int minimum;
+    int maximum;
 
-    int global_time;
-    int cpu_fraction;
+    static int top_bit(int value)
+    {
+        int bit = 7;
+        while ((value >> (bit + 1)) != 0)
+            ++bit;
+        return bit;
+    }
 
-public:
-    RoundRobinScheduler(const Simulation_data &data)
+    static int bucket_of(int value)
     {
-        management_infos = data.management_infos;
-        devices_list = data.devices;
-        processes_list = data.processes;
-        cpu_fraction = management_infos.cpu_fraction;
-        global_time = 0;
+        if (value < LINEAR_LIMIT)
+            return std::max(value, 0);
+        int bit = top_bit(value);
+        int shift = bit - 6;
+        return LINEAR_LIMIT + (bit - 7) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
 
-        io_manager = new IOManager(&devices_list, &blocked_list);
+    // valor central da faixa
+    static int bucket_value(int bucket)
+    {
+        if (bucket < LINEAR_LIMIT)
+            return bucket;
+        int offset = bucket - LINEAR_LIMIT;
+        int shift = offset / SUB_BUCKETS + 1;
+        long long low = (long long)(SUB_BUCKETS + offset % SUB_BUCKETS) << shift;
+        return (int)(low + ((1LL << shift) - 1) / 2);
     }
 
-    ~RoundRobinScheduler()
+public:
+    Latency_histogram() : counts(BUCKETS, 0), total(0), sum(0), minimum(INT32_MAX), maximum(0) {}
+
+    void add(int value)
     {
-        delete io_manager;
+        value = std::max(value, 0);
+        counts[bucket_of(value)]++;
+        total++;
+        sum += value;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
     }
 
-    // checa se todos os processos terminaram
-    bool all_processes_finished()
+    void merge(const Latency_histogram &other)
     {
-        return (int)finished_list.size() == management_infos.num_processes;
+        for (int b = 0; b < BUCKETS; ++b)
+            counts[b] += other.counts[b];
+        total += other.total;
+        sum += other.sum;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
     }
 
-    // retorna o nome do dispositivo que o pid está usando
-    std::string device_using_by_pid(int pid)
+    uint64_t count() const { return total; }
+    int max() const { return maximum; }
+    double mean() const { return total ? (double)sum / (double)total : 0.0; }
+
+    // menor faixa que acumula pelo menos q do total, limitada ao mínimo/máximo observados
+    int quantile(double q) const
     {
-        for (auto &dev : devices_list)
+        if (total == 0)
+            return 0;
+        uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(q * (double)total));
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b)
         {
-            for (int u : dev.processes_using_devices)
-                if (u == pid)
-                    return dev.name_id;
+            seen += counts[b];
+            if (seen >= rank)
+                return std::min(std::max(bucket_value(b), minimum), maximum);
         }
-        return "";
+        return maximum;
     }
+};
 
-    // retorna dispositivos onde o pid está na fila de espera 
-    std::string device_waiting_by_pid(int pid)
+// as quatro medidas do relatório final para um grupo de processos
+struct Summary_metrics
+{
+    Latency_histogram turnaround;
+    Latency_histogram ready;
+    Latency_histogram blocked;
+    Latency_histogram io;
+
+    void add(const Process &proc)
     {
-        for (auto &dev : devices_list)
-        {
-            std::queue<int> temp = dev.waiting_processes;
-            while (!temp.empty())
-            {
-                if (temp.front() == pid)
-                    return dev.name_id;
-                temp.pop();
-            }
-        }
-        return "";
+        turnaround.add(proc.finish_time - proc.creation_time);
+        ready.add(proc.ready_time);
+        blocked.add(proc.blocked_time);
+        io.add(proc.total_io_time);
     }
 
-    // imprime o estado do sistema no momento de troca de processo
-    void print_system_state(Process *running_process)
+    void merge(const Summary_metrics &other)
     {
-        std::cout << "==================== Estado do sistema (t=" << global_time << ") ====================\n";
+        turnaround.merge(other.turnaround);
+        ready.merge(other.ready);
+        blocked.merge(other.blocked);
+        io.merge(other.io);
+    }
+};
 
-        
-        if (running_process)
-        {
-            std::cout << "CPU: PID " << running_process->pid
-                      << " (remaining=" << running_process->remaining_time << ")\n";
-        }
-        else
-        {
-            std::cout << "CPU: idle\n";
-        }
+// resumo em percentis alimentado a cada processo que termina; os grupos são faixas fixas,
+// então a memória não depende do número de processos nem dos valores de prioridade
+class Summary_report
+{
+private:
+    Summary_metrics all;
+    std::map<int, Summary_metrics> by_priority;  // faixas de 10; negativas na primeira, 90+ na última
+    std::map<int, Summary_metrics> by_io_chance; // faixas de 10 pontos percentuais
+    int first_creation;
+    int last_finish;
 
-        // prontos
-        std::cout << "Prontos: ";
-        bool any_ready = false;
-        for (auto &proc : processes_list)
-        {
-            if (proc.is_ready && !proc.is_running && !proc.is_finished)
-            {
-                any_ready = true;
-                std::cout << "PID " << proc.pid << "(rem=" << proc.remaining_time << ") ";
-            }
-        }
+    static int priority_bucket(int priority)
+    {
+        return std::min(std::max(priority, 0) / 10, 9);
+    }
+
+    static int io_chance_bucket(int io_chance)
+    {
+        return std::min(std::max(io_chance, 0) / 10, 9);
+    }
+
+    static void print_metric(std::ostream &out, const std::string &group, const char *name,
+                             const Latency_histogram &histogram)
+    {
+        out << std::setw(24) << group << std::setw(13) << name
+            << std::right << std::setw(11) << histogram.mean()
+            << std::setw(9) << histogram.quantile(0.50)
+            << std::setw(9) << histogram.quantile(0.90)
+            << std::setw(9) << histogram.quantile(0.99)
+            << std::setw(9) << histogram.quantile(0.999)
+            << std::setw(9) << histogram.max() << std::left << "\n";
+    }
+
+    static void print_group(std::ostream &out, const std::string &group, const Summary_metrics &metrics)
+    {
+        std::string label = group + " (" + std::to_string(metrics.turnaround.count()) + ")";
+        print_metric(out, label, "Turnaround", metrics.turnaround);
+        print_metric(out, "", "TempoPronto", metrics.ready);
+        print_metric(out, "", "TempoBloq", metrics.blocked);
+        print_metric(out, "", "TotalIO", metrics.io);
+    }
+
+public:
+    Summary_report() : first_creation(INT32_MAX), last_finish(0) {}
+
+    void add(const Process &proc)
+    {
+        all.add(proc);
+        by_priority[priority_bucket(proc.priority)].add(proc);
+        by_io_chance[io_chance_bucket(proc.io_chance)].add(proc);
+        first_creation = std::min(first_creation, proc.creation_time);
+        last_finish = std::max(last_finish, proc.finish_time);
+    }
+
+    void merge(const Summary_report &other)
+    {
+        all.merge(other.all);
+        for (const auto &group : other.by_priority)
+            by_priority[group.first].merge(group.second);
+        for (const auto &group : other.by_io_chance)
+            by_io_chance[group.first].merge(group.second);
+        first_creation = std::min(first_creation, other.first_creation);
+        last_finish = std::max(last_finish, other.last_finish);
+    }
+
+    void print(std::ostream &out) const
+    {
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+
+        uint64_t processes = all.turnaround.count();
+        int window = processes ? last_finish - first_creation : 0;
+        out << std::fixed << std::setprecision(2) << std::left;
+        out << "\n==================== Resumo da execucao ====================\n";
+        out << "Processos: " << processes;
+        if (processes)
+            out << "  janela t=" << first_creation << ".." << last_finish;
+        out << "  vazao: " << std::setprecision(4)
+            << (window > 0 ? (double)processes / (double)window : 0.0)
+            << " processos/t\n" << std::setprecision(2);
+
+        out << std::setw(24) << "Grupo" << std::setw(13) << "Metrica"
+            << std::right << std::setw(11) << "Media"
+            << std::setw(9) << "p50" << std::setw(9) << "p90" << std::setw(9) << "p99"
+            << std::setw(9) << "p999" << std::setw(9) << "Max" << std::left << "\n";
+
+        print_group(out, "todos", all);
+        for (const auto &group : by_priority)
+        {
+            int low = group.first * 10;
+            std::string range = group.first == 9 ? "90+" : std::to_string(low) + "-" + std::to_string(low + 9);
+            print_group(out, "prioridade " + range, group.second);
+        }
+        for (const auto &group : by_io_chance)
+        {
+            int low = group.first * 10;
+            std::string range = std::to_string(low) + "-" + std::to_string(group.first == 9 ? 100 : low + 9);
+            print_group(out, "E/S " + range + "%", group.second);
+        }
+        out << "============================================================\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+// relatório final comum ao escalonador sequencial e ao paralelo
+void write_final_report(std::ostream &out, const std::vector<Process> &processes)
+{
+    out << "\n==================== Relatorio final ====================\n";
+    out << std::left << std::setw(6) << "PID"
+        << std::setw(12) << "Turnaround"
+        << std::setw(12) << "TempoPronto"
+        << std::setw(12) << "TempoBloq"
+        << std::setw(12) << "TotalIO"
+        << "\n";
+
+    for (const auto &proc : processes)
+    {
+        int turnaround = proc.finish_time - proc.creation_time;
+        out << std::left << std::setw(6) << proc.pid
+            << std::setw(12) << turnaround
+            << std::setw(12) << proc.ready_time
+            << std::setw(12) << proc.blocked_time
+            << std::setw(12) << proc.total_io_time
+            << "\n";
+    }
+    out << "=========================================================\n";
+}
+
+template <typename Log>
+class Basic_round_robin_scheduler
+{
+private:
+    Management_Infos management_infos;
+    std::vector<Device> devices_list;
+    std::vector<Process> processes_list;
+    std::queue<Process *> ready_queue; // processos em estado de pronto
+    std::vector<Process> finished_list; // processos finalizados
+    std::vector<Process *> blocked_list; // processos em estado de bloqueado
+    IOManager<Log> *io_manager;
+    std::ostream *log;
+    Replay_recorder *recorder;
+    Summary_report *summary;
+
+    int global_time;
+    int cpu_fraction;
+
+public:
+    Basic_round_robin_scheduler(const Simulation_data &data, uint64_t seed)
+    {
+        management_infos = data.management_infos;
+        devices_list = data.devices;
+        processes_list = data.processes;
+        cpu_fraction = management_infos.cpu_fraction;
+        global_time = 0;
+        log = &std::cout;
+        recorder = nullptr;
+        summary = nullptr;
+
+        io_manager = new IOManager<Log>(&devices_list, &blocked_list, seed);
+    }
+
+    // destino das mensagens da simulação (std::cout por padrão)
+    void set_log(std::ostream *stream)
+    {
+        log = stream;
+        io_manager->set_log(stream);
+    }
+
+    void set_recorder(Replay_recorder *replay)
+    {
+        recorder = replay;
+        io_manager->set_recorder(replay);
+    }
+
+    // troca a tabela por PID pelo resumo em percentis; inclui quem já terminou antes de um checkpoint
+    void set_summary(Summary_report *report)
+    {
+        summary = report;
+        for (const auto &proc : finished_list)
+            summary->add(proc);
+    }
+
+    int get_global_time() const { return global_time; }
+    const std::vector<Process> &get_processes() const { return processes_list; }
+
+    ~Basic_round_robin_scheduler()
+    {
+        delete io_manager;
+    }
+
+    // checa se todos os processos terminaram
+    bool all_processes_finished()
+    {
+        return (int)finished_list.size() == management_infos.num_processes;
+    }
+
+    // retorna o nome do dispositivo que o pid está usando
+    std::string device_using_by_pid(int pid)
+    {
+        for (auto &dev : devices_list)
+        {
+            for (int u : dev.processes_using_devices)
+                if (u == pid)
+                    return dev.name_id;
+        }
+        return "";
+    }
+
+    // retorna dispositivos onde o pid está na fila de espera 
+    std::string device_waiting_by_pid(int pid)
+    {
+        for (auto &dev : devices_list)
+        {
+            std::queue<int> temp = dev.waiting_processes;
+            while (!temp.empty())
+            {
+                if (temp.front() == pid)
+                    return dev.name_id;
+                temp.pop();
+            }
+        }
+        return "";
+    }
+
+    // imprime o estado do sistema no momento de troca de processo
+    void print_system_state(Process *running_process)
+    {
+        *log << "==================== Estado do sistema (t=" << global_time << ") ====================\n";
+
+        
+        if (running_process)
+        {
+            *log << "CPU: PID " << running_process->pid
+                 << " (remaining=" << running_process->remaining_time << ")\n";
+        }
+        else
+        {
+            *log << "CPU: idle\n";
+        }
+
+        // prontos
+        *log << "Prontos: ";
+        bool any_ready = false;
+        for (auto &proc : processes_list)
+        {
+            if (proc.is_ready && !proc.is_running && !proc.is_finished)
+            {
+                any_ready = true;
+                *log << "PID " << proc.pid << "(rem=" << proc.remaining_time << ") ";
+            }
+        }
         if (!any_ready)
-            std::cout << "nenhum";
-        std::cout << "\n";
+            *log << "nenhum";
+        *log << "\n";
 
         // bloqueados 
-        std::cout << "Bloqueados:\n";
+        *log << "Bloqueados:\n";
         bool any_blocked = false;
         for (auto &proc : processes_list)
         {
@@ -446,396 +1316,3426 @@ public:
                 any_blocked = true;
                 std::string using_dev = device_using_by_pid(proc.pid);
                 std::string waiting_dev = device_waiting_by_pid(proc.pid);
-                std::cout << "  PID " << proc.pid << " (rem=" << proc.remaining_time << ")";
+                *log << "  PID " << proc.pid << " (rem=" << proc.remaining_time << ")";
                 if (!using_dev.empty())
-                    std::cout << " usando " << using_dev;
+                    *log << " usando " << using_dev;
                 else if (!waiting_dev.empty())
-                    std::cout << " aguardando " << waiting_dev;
-                std::cout << "\n";
+                    *log << " aguardando " << waiting_dev;
+                *log << "\n";
             }
         }
         if (!any_blocked)
-            std::cout << "  nenhum\n";
+            *log << "  nenhum\n";
 
         // imprime estado dos dispositivos
-        std::cout << "Dispositivos:\n";
+        *log << "Dispositivos:\n";
         for (auto &dev : devices_list)
         {
-            std::cout << "  " << dev.name_id << " (op_time=" << dev.operation_time
-                      << ", slots=" << dev.simultaneous_uses << ") ";
+            *log << "  " << dev.name_id << " (op_time=" << dev.operation_time
+                 << ", slots=" << dev.simultaneous_uses << ") ";
             if (dev.is_busy)
-                std::cout << "[BUSY]\n";
+                *log << "[BUSY]\n";
             else
-                std::cout << "[FREE]\n";
+                *log << "[FREE]\n";
 
-            std::cout << "    Usando: ";
+            *log << "    Usando: ";
             if (dev.processes_using_devices.empty())
-                std::cout << "nenhum";
+                *log << "nenhum";
             else
             {
                 for (int pid : dev.processes_using_devices)
-                    std::cout << pid << " ";
+                    *log << pid << " ";
             }
-            std::cout << "\n";
+            *log << "\n";
 
-            std::cout << "    Fila: ";
+            *log << "    Fila: ";
             if (dev.waiting_processes.empty())
-                std::cout << "vazia";
+                *log << "vazia";
             else
             {
                 std::queue<int> temp = dev.waiting_processes;
                 while (!temp.empty())
                 {
-                    std::cout << temp.front() << " ";
+                    *log << temp.front() << " ";
                     temp.pop();
                 }
             }
-            std::cout << "\n";
+            *log << "\n";
         }
 
-        std::cout << "====================================================================\n";
+        *log << "====================================================================\n";
+    }
+
+    void print_final_report()
+    {
+        if (summary)
+            summary->print(*log);
+        else
+            write_final_report(*log, processes_list);
+    }
+
+    void take_snapshot()
+    {
+        Binary_writer state;
+        save_state(state);
+        recorder->add_snapshot(global_time, state);
+    }
+
+    // grava o estado dinâmico; o estático (pids, tempos, dispositivos) vem do arquivo de entrada
+    void save_state(Binary_writer &out) const
+    {
+        out.put_int(global_time);
+        out.put_uint(io_manager->get_random_state());
+
+        out.put_uint(processes_list.size());
+        for (const auto &proc : processes_list)
+        {
+            out.put_int(proc.pid);
+            out.put_int(proc.remaining_time);
+            out.put_uint((proc.is_finished ? 1u : 0u) | (proc.is_blocked ? 2u : 0u) |
+                         (proc.is_running ? 4u : 0u) | (proc.is_ready ? 8u : 0u) |
+                         (proc.is_io_pending ? 16u : 0u) | (proc.is_using_io ? 32u : 0u));
+            out.put_int(proc.ready_time);
+            out.put_int(proc.blocked_time);
+            out.put_int(proc.start_time);
+            out.put_int(proc.finish_time);
+            out.put_int(proc.turnaround_time);
+            out.put_int(proc.waiting_time);
+            out.put_int(proc.io_start_time);
+            out.put_int(proc.io_end_time);
+            out.put_int(proc.total_io_time);
+        }
+
+        // filas guardadas como índices em processes_list, na ordem atual
+        std::queue<Process *> temp = ready_queue;
+        out.put_uint(temp.size());
+        while (!temp.empty())
+        {
+            out.put_uint((uint64_t)(temp.front() - processes_list.data()));
+            temp.pop();
+        }
+
+        out.put_uint(blocked_list.size());
+        for (const Process *proc : blocked_list)
+            out.put_uint((uint64_t)(proc - processes_list.data()));
+
+        out.put_uint(finished_list.size());
+        for (const auto &proc : finished_list)
+            out.put_int(proc.pid);
+
+        out.put_uint(devices_list.size());
+        for (const auto &dev : devices_list)
+        {
+            out.put_uint(dev.is_busy ? 1 : 0);
+            out.put_uint(dev.processes_using_devices.size());
+            for (int pid : dev.processes_using_devices)
+                out.put_int(pid);
+
+            std::queue<int> waiting = dev.waiting_processes;
+            out.put_uint(waiting.size());
+            while (!waiting.empty())
+            {
+                out.put_int(waiting.front());
+                waiting.pop();
+            }
+        }
+    }
+
+    void load_state(Binary_reader &in)
+    {
+        const std::runtime_error mismatch("Checkpoint incompativel com o arquivo de entrada");
+
+        global_time = (int)in.get_int();
+        io_manager->set_random_state(in.get_uint());
+
+        if (in.get_uint() != processes_list.size())
+            throw mismatch;
+        for (auto &proc : processes_list)
+        {
+            if (in.get_int() != proc.pid)
+                throw mismatch;
+            proc.remaining_time = (int)in.get_int();
+            uint64_t flags = in.get_uint();
+            proc.is_finished = flags & 1;
+            proc.is_blocked = flags & 2;
+            proc.is_running = flags & 4;
+            proc.is_ready = flags & 8;
+            proc.is_io_pending = flags & 16;
+            proc.is_using_io = flags & 32;
+            proc.ready_time = (int)in.get_int();
+            proc.blocked_time = (int)in.get_int();
+            proc.start_time = (int)in.get_int();
+            proc.finish_time = (int)in.get_int();
+            proc.turnaround_time = (int)in.get_int();
+            proc.waiting_time = (int)in.get_int();
+            proc.io_start_time = (int)in.get_int();
+            proc.io_end_time = (int)in.get_int();
+            proc.total_io_time = (int)in.get_int();
+        }
+
+        auto read_index = [&]()
+        {
+            uint64_t index = in.get_uint();
+            if (index >= processes_list.size())
+                throw mismatch;
+            return &processes_list[index];
+        };
+
+        ready_queue = std::queue<Process *>();
+        for (uint64_t n = in.get_uint(); n > 0; --n)
+            ready_queue.push(read_index());
+
+        blocked_list.clear();
+        for (uint64_t n = in.get_uint(); n > 0; --n)
+            blocked_list.push_back(read_index());
+
+        finished_list.clear();
+        for (uint64_t n = in.get_uint(); n > 0; --n)
+        {
+            int pid = (int)in.get_int();
+            auto it = std::find_if(processes_list.begin(), processes_list.end(),
+                                   [pid](const Process &p)
+                                   { return p.pid == pid; });
+            if (it == processes_list.end())
+                throw mismatch;
+            finished_list.push_back(*it);
+        }
+
+        if (in.get_uint() != devices_list.size())
+            throw mismatch;
+        for (auto &dev : devices_list)
+        {
+            dev.is_busy = in.get_uint() != 0;
+            dev.processes_using_devices.clear();
+            for (uint64_t n = in.get_uint(); n > 0; --n)
+                dev.processes_using_devices.push_back((int)in.get_int());
+
+            dev.waiting_processes = std::queue<int>();
+            for (uint64_t n = in.get_uint(); n > 0; --n)
+                dev.waiting_processes.push((int)in.get_int());
+        }
+    }
+
+    // atualiza fila de prontos 
+    void update_ready_queue()
+    {
+        for (auto &process : processes_list)
+        {
+            if (process.creation_time <= global_time &&
+                !process.is_finished &&
+                !process.is_ready &&
+                !process.is_blocked &&
+                !process.is_running) 
+            {
+                process.is_ready = true;
+                ready_queue.push(&process);
+                note(EVENT_READY, process.pid);
+            }
+        }
+    }
+
+    // registra um evento no índice de replay, se houver
+    void note(Replay_event_type type, int pid, int time = -1)
+    {
+        if (recorder)
+            recorder->record(time < 0 ? global_time : time, type, pid);
+    }
+
+    // executa um passo: despacha um processo ou avança um tick com a CPU ociosa
+    void step()
+    {
+        // escolher próximo processo 
+        if (!ready_queue.empty())
+        {
+            Process *process = ready_queue.front();
+            ready_queue.pop();
+
+            process->is_running = true;
+            process->is_ready = false;
+            note(EVENT_DISPATCH, process->pid);
+
+            if (Log::enabled)
+                print_system_state(process);
+
+            // chama gerenciador de entrada/saída
+            int time_until_io = io_manager->handle_io(*process, cpu_fraction, global_time);
+
+            int time_advance = 0;
+
+            if (time_until_io > 0)
+            {
+                // o processo requisitou entrada/saída ficando bloqueado
+                time_advance = time_until_io;
+            }
+            else
+            {
+                // não houve entrada/saída continua rodando normal
+                int slice_used = std::min(cpu_fraction, process->remaining_time);
+                process->remaining_time -= slice_used;
+                time_advance = slice_used;
+
+                if (process->remaining_time <= 0)
+                {
+                    process->is_finished = true;
+                    process->finish_time = global_time + slice_used;
+                    process->turnaround_time = process->finish_time - process->creation_time;
+                    process->waiting_time = process->turnaround_time - process->execution_time;
+                    finished_list.push_back(*process);
+                    if (summary)
+                        summary->add(*process);
+                    note(EVENT_FINISH, process->pid, process->finish_time);
+
+                    if (Log::enabled)
+                        *log << "[CPU] PID " << process->pid << " finalizou em t=" << process->finish_time << "\n";
+                }
+                else
+                {
+                    // volta para fila de prontos
+                    process->is_running = false;
+                    process->is_ready = true;
+                    ready_queue.push(process);
+                    note(EVENT_READY, process->pid, global_time + slice_used);
+                }
+            }
+
+            // avança o tempo global pelo período consumido 
+            if (time_advance > 0)
+            {
+                // atualizar contadores por todos os processos pelo tempo avançado
+                for (auto &proc : processes_list)
+                {
+                    if (proc.is_blocked)
+                        proc.blocked_time += time_advance;
+                    else if (proc.is_ready && !proc.is_running && !proc.is_finished)
+                        proc.ready_time += time_advance;
+                }
+
+                global_time += time_advance;
+            }
+
+            // após avanço de tempo atualiza estado dos dispositivos
+            io_manager->update_devices(global_time, processes_list);
+
+            // tira de bloqueado e coloca na fila de prontos
+            for (auto it = blocked_list.begin(); it != blocked_list.end();)
+            {
+                Process *proc_ptr = *it;
+                if (!proc_ptr->is_blocked && !proc_ptr->is_running)
+                {
+                    proc_ptr->is_ready = true;
+                    ready_queue.push(proc_ptr);
+                    note(EVENT_READY, proc_ptr->pid);
+                    it = blocked_list.erase(it);
+                }
+                else
+                    ++it;
+            }
+
+            // atualiza fila de prontos
+            update_ready_queue();
+        }
+        else
+        {
+            // CPU ociosa avança tempo até o próximo evento
+            for (auto &proc : processes_list)
+            {
+                if (proc.is_blocked)
+                    proc.blocked_time++;
+                else if (proc.is_ready && !proc.is_running && !proc.is_finished)
+                    proc.ready_time++;
+            }
+
+            global_time++;
+            io_manager->update_devices(global_time, processes_list);
+
+            for (auto it = blocked_list.begin(); it != blocked_list.end();)
+            {
+                Process *proc_ptr = *it;
+                if (!proc_ptr->is_blocked)
+                {
+                    proc_ptr->is_ready = true;
+                    ready_queue.push(proc_ptr);
+                    note(EVENT_READY, proc_ptr->pid);
+                    it = blocked_list.erase(it);
+                }
+                else
+                    ++it;
+            }
+
+            update_ready_queue();
+        }
+    }
+
+    void run(Checkpoint_manager *checkpoints = nullptr)
+    {
+        // chama a atualização
+        update_ready_queue();
+
+        if (recorder)
+            take_snapshot();
+
+        while (!all_processes_finished())
+        {
+            step();
+
+            if (recorder && recorder->step_done(global_time))
+                take_snapshot();
+
+            if (checkpoints && checkpoints->due())
+            {
+                Binary_writer state;
+                save_state(state);
+                checkpoints->save(CHECKPOINT_SCHEDULER, state);
+            }
+        }
+
+        print_final_report();
     }
+};
+
+using RoundRobinScheduler = Basic_round_robin_scheduler<Log_verbose>;
+
+// fila circular sem trava com exatamente um produtor e um consumidor; quem encontra a
+// fila vazia (ou cheia) dorme na variável de condição até o outro lado mexer nela
+template <typename T>
+class Spsc_queue
+{
+private:
+    std::vector<T> buffer;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head; // próxima posição lida pelo consumidor
+    alignas(64) std::atomic<size_t> tail; // próxima posição escrita pelo produtor
+    alignas(64) std::atomic<bool> consumer_sleeping;
+    std::atomic<bool> producer_sleeping;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    bool empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_relaxed); }
+    bool full() const { return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed) == buffer.size(); }
+
+    // par do sleep_while: quem mexe na fila publica a posição e depois olha a bandeira,
+    // quem dorme publica a bandeira e depois olha a posição, então um dos dois enxerga o outro
+    void wake_other(const std::atomic<bool> &sleeping)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_one();
+        }
+    }
+
+    template <typename Blocked>
+    void sleep_while(std::atomic<bool> &sleeping, Blocked blocked, const std::chrono::milliseconds *limit)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blocked())
+        {
+            if (limit)
+                wake.wait_for(lock, *limit);
+            else
+                wake.wait(lock);
+        }
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+
+public:
+    // capacidade precisa ser potência de dois
+    explicit Spsc_queue(size_t capacity)
+        : buffer(capacity), mask(capacity - 1), head(0), tail(0), consumer_sleeping(false), producer_sleeping(false) {}
+
+    bool try_push(const T &item)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) == buffer.size())
+            return false;
+        buffer[position & mask] = item;
+        tail.store(position + 1, std::memory_order_release);
+        wake_other(consumer_sleeping);
+        return true;
+    }
+
+    bool try_pop(T &item)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire))
+            return false;
+        item = buffer[position & mask];
+        head.store(position + 1, std::memory_order_release);
+        wake_other(producer_sleeping);
+        return true;
+    }
+
+    void push(const T &item)
+    {
+        while (!try_push(item))
+            sleep_while(producer_sleeping, [this]
+                        { return full(); }, nullptr);
+    }
+
+    void pop(T &item)
+    {
+        while (!try_pop(item))
+            sleep_while(consumer_sleeping, [this]
+                        { return empty(); }, nullptr);
+    }
+
+    // espera espaço por no máximo limit; o produtor pode ter outra fila para esvaziar antes
+    void wait_for_space(std::chrono::milliseconds limit)
+    {
+        sleep_while(producer_sleeping, [this]
+                    { return full(); }, &limit);
+    }
+};
+
+enum Partition_message_type
+{
+    PARTITION_REQUEST, // processo pediu E/S num dispositivo da partição
+    PARTITION_ADVANCE, // processa as conclusões até o instante indicado
+    PARTITION_STOP
+};
+
+struct Partition_message
+{
+    int type;
+    int process; // índice em processes_list
+    int device;  // índice global do dispositivo
+    int time;
+};
+
+// process >= 0: conclusão de E/S; process < 0: fim do avanço, time = próximo evento da partição
+struct Partition_reply
+{
+    int process;
+    int time;
+    int operation_time;
+};
+
+// partição de dispositivos com fila de eventos própria, executada numa thread
+class Device_partition
+{
+private:
+    struct Partition_device
+    {
+        int operation_time;
+        int simultaneous_uses;
+        std::vector<std::pair<int, int>> in_use; // (processo, início da E/S) na ordem de entrada
+        std::queue<int> waiting;
+    };
+
+    typedef std::pair<int, int> Completion; // (instante de conclusão, dispositivo local)
+
+    std::vector<Partition_device> devices; // dispositivo global d fica na posição d / stride
+    std::priority_queue<Completion, std::vector<Completion>, std::greater<Completion>> completions;
+    std::vector<int> touched;
+    int stride;
+    std::thread worker;
+
+public:
+    Spsc_queue<Partition_message> inbox;
+    Spsc_queue<Partition_reply> outbox;
+
+    Device_partition(const std::vector<Device> &all_devices, int index, int partition_count)
+        : stride(partition_count), inbox(1 << 16), outbox(1 << 16)
+    {
+        for (size_t d = index; d < all_devices.size(); d += partition_count)
+        {
+            Partition_device device;
+            device.operation_time = all_devices[d].operation_time;
+            device.simultaneous_uses = all_devices[d].simultaneous_uses;
+            devices.push_back(device);
+        }
+    }
+
+    ~Device_partition()
+    {
+        stop();
+    }
+
+    void start()
+    {
+        worker = std::thread(&Device_partition::serve, this);
+    }
+
+    void stop()
+    {
+        if (!worker.joinable())
+            return;
+        inbox.push({PARTITION_STOP, 0, 0, 0});
+        worker.join();
+    }
+
+private:
+    void serve()
+    {
+        Partition_message message;
+        for (;;)
+        {
+            inbox.pop(message);
+            if (message.type == PARTITION_STOP)
+                return;
+            if (message.type == PARTITION_REQUEST)
+                request(message.process, message.device / stride, message.time);
+            else
+                advance(message.time);
+        }
+    }
+
+    // mesma regra do IOManager::handle_io: usa um slot livre ou entra na fila de espera
+    void request(int process, int device_index, int io_start)
+    {
+        Partition_device &device = devices[device_index];
+        if ((int)device.in_use.size() < device.simultaneous_uses)
+        {
+            device.in_use.push_back({process, io_start});
+            completions.push({io_start + device.operation_time, device_index});
+        }
+        else
+            device.waiting.push(process);
+    }
+
+    // mesma regra do IOManager::update_devices, visitando só os dispositivos com conclusões até time
+    void advance(int time)
+    {
+        // retira antes de promover: quem começa agora só pode terminar num avanço futuro
+        touched.clear();
+        while (!completions.empty() && completions.top().first <= time)
+        {
+            touched.push_back(completions.top().second);
+            completions.pop();
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+        for (int device_index : touched)
+        {
+            Partition_device &device = devices[device_index];
+            for (auto it = device.in_use.begin(); it != device.in_use.end();)
+            {
+                if (time - it->second >= device.operation_time)
+                {
+                    outbox.push({it->first, time, device.operation_time});
+                    it = device.in_use.erase(it);
+                }
+                else
+                    ++it;
+            }
+
+            while ((int)device.in_use.size() < device.simultaneous_uses && !device.waiting.empty())
+            {
+                device.in_use.push_back({device.waiting.front(), time});
+                device.waiting.pop();
+                completions.push({time + device.operation_time, device_index});
+            }
+        }
+
+        outbox.push({-1, completions.empty() ? INT32_MAX : completions.top().first, 0});
+    }
+};
+
+// alternância circular com os dispositivos distribuídos entre threads.
+// A thread principal é a partição da CPU: guarda o sorteio, a fila de prontos e o estado
+// dos processos, então a sequência sorteada é a mesma do escalonador sequencial. Cada
+// partição de dispositivos só precisa sincronizar quando o relógio alcança seu horizonte:
+// nenhuma E/S termina antes de início + operation_time, e a CPU só observa os dispositivos
+// nas fronteiras de fatia (no máximo cpu_fraction à frente).
+// O avanço não espera a resposta: um marcador entra na fila de prontos no lugar dos
+// desbloqueados daquele instante e a CPU segue despachando quem está na frente dele. Só
+// quando o marcador chega à frente é que a resposta é necessária, então as partições
+// trabalham enquanto a CPU percorre a fila. Os processos em si não são repartidos: a ordem
+// de despacho e o sorteio são globais e ficam numa só thread.
+class Parallel_round_robin_scheduler
+{
+private:
+    enum Accounting_state
+    {
+        ACCOUNT_NONE,
+        ACCOUNT_READY,
+        ACCOUNT_BLOCKED
+    };
+
+    Management_Infos management_infos;
+    std::vector<Device> devices_list;
+    std::vector<Process> processes_list;
+    std::vector<Process *> unused_blocked_list; // o IOManager só é usado para os sorteios
+    IOManager<Log_quiet> io_manager;
+    std::ostream *log;
+    Summary_report *summary;
+
+    // conclusões de um avanço pedido no instante time; o marcador na fila de prontos é o lugar delas
+    struct Sync_record
+    {
+        int time;
+        int remaining; // partições que ainda não responderam
+        std::vector<Partition_reply> completions;
+    };
+
+    enum
+    {
+        SYNC_MARKER = -1
+    };
+
+    std::deque<int> ready_queue; // índices em processes_list ou SYNC_MARKER
+    std::vector<int> arrival_order; // índices ordenados por criação
+    size_t next_arrival;
+
+    // tempos de pronto/bloqueado acumulados só quando o estado do processo muda
+    std::vector<uint8_t> accounting;
+    std::vector<int> accounted_until;
+    std::vector<uint64_t> blocked_order; // ordem na lista de bloqueados do sequencial
+    uint64_t blocked_sequence;
+
+    std::vector<std::unique_ptr<Device_partition>> partitions;
+    std::vector<int> horizon;       // antes disso a partição não tem conclusões; vale sem avanços pendentes
+    std::vector<int> request_bound; // menor conclusão possível das E/S pedidas desde o último avanço
+    std::vector<std::queue<uint64_t>> outstanding; // avanços de cada partição ainda sem resposta
+    std::deque<Sync_record> sync_records;
+    uint64_t first_sync; // identificador de sync_records.front()
+    uint64_t synchronizations;
+
+    int global_time;
+    int cpu_fraction;
+    int finished_count;
+
+public:
+    Parallel_round_robin_scheduler(const Simulation_data &data, uint64_t seed, int workers)
+        : management_infos(data.management_infos), devices_list(data.devices), processes_list(data.processes),
+          io_manager(&devices_list, &unused_blocked_list, seed), log(&std::cout), summary(nullptr), next_arrival(0),
+          accounting(data.processes.size(), ACCOUNT_NONE), accounted_until(data.processes.size(), 0),
+          blocked_order(data.processes.size(), 0), blocked_sequence(0), first_sync(0), synchronizations(0),
+          global_time(0), cpu_fraction(data.management_infos.cpu_fraction), finished_count(0)
+    {
+        for (size_t i = 0; i < processes_list.size(); ++i)
+            arrival_order.push_back((int)i);
+        std::stable_sort(arrival_order.begin(), arrival_order.end(), [this](int a, int b)
+                         { return processes_list[a].creation_time < processes_list[b].creation_time; });
+
+        int partition_count = std::max(1, std::min(workers, (int)devices_list.size()));
+        for (int p = 0; p < partition_count; ++p)
+            partitions.emplace_back(new Device_partition(devices_list, p, partition_count));
+        horizon.assign(partition_count, INT32_MAX);
+        request_bound.assign(partition_count, INT32_MAX);
+        outstanding.resize(partition_count);
+    }
+
+    // o modo paralelo endereça processos por índice e sempre sorteia um dispositivo
+    static std::string unsupported_reason(const Simulation_data &data)
+    {
+        if (data.devices.empty())
+            return "nenhum dispositivo declarado";
+        std::vector<int> pids;
+        for (const auto &proc : data.processes)
+            pids.push_back(proc.pid);
+        std::sort(pids.begin(), pids.end());
+        if (std::adjacent_find(pids.begin(), pids.end()) != pids.end())
+            return "PIDs repetidos";
+        return "";
+    }
+
+    void set_log(std::ostream *stream) { log = stream; }
+    void set_summary(Summary_report *report) { summary = report; }
+    const std::vector<Process> &get_processes() const { return processes_list; }
+
+    void run()
+    {
+        for (auto &partition : partitions)
+            partition->start();
+
+        admit_arrivals();
+        while (finished_count < management_infos.num_processes)
+        {
+            if (ready_queue.empty())
+                skip_idle();
+            else if (ready_queue.front() == SYNC_MARKER)
+                resolve_sync();
+            else
+                dispatch();
+        }
+
+        // sobram só marcadores vazios; as respostas precisam sair das filas antes do STOP
+        while (!ready_queue.empty())
+            resolve_sync();
+
+        for (auto &partition : partitions)
+            partition->stop();
+
+        std::cerr << "[PARALELO] " << partitions.size() << " particoes de dispositivos, "
+                  << synchronizations << " sincronizacoes\n";
+        if (summary)
+            summary->print(*log);
+        else
+            write_final_report(*log, processes_list);
+    }
+
+private:
+    static int state_of(const Process &proc)
+    {
+        if (proc.is_blocked)
+            return ACCOUNT_BLOCKED;
+        if (proc.is_ready && !proc.is_running && !proc.is_finished)
+            return ACCOUNT_READY;
+        return ACCOUNT_NONE;
+    }
+
+    // fecha o intervalo no estado anterior e passa a contar no estado atual a partir de time
+    void account(int index, int time)
+    {
+        Process &proc = processes_list[index];
+        int elapsed = time - accounted_until[index];
+        if (accounting[index] == ACCOUNT_BLOCKED)
+            proc.blocked_time += elapsed;
+        else if (accounting[index] == ACCOUNT_READY)
+            proc.ready_time += elapsed;
+        accounted_until[index] = time;
+        accounting[index] = (uint8_t)state_of(proc);
+    }
+
+    void account(int index)
+    {
+        account(index, global_time);
+    }
+
+    void make_ready(int index)
+    {
+        processes_list[index].is_ready = true;
+        ready_queue.push_back(index);
+        account(index);
+    }
+
+    // chegadas entram na ordem da lista de processos, como no update_ready_queue
+    void admit_arrivals()
+    {
+        size_t first = next_arrival;
+        while (next_arrival < arrival_order.size() &&
+               processes_list[arrival_order[next_arrival]].creation_time <= global_time)
+            ++next_arrival;
+        std::sort(arrival_order.begin() + first, arrival_order.begin() + next_arrival);
+        for (size_t i = first; i < next_arrival; ++i)
+            make_ready(arrival_order[i]);
+    }
+
+    // recolhe o que a partição já respondeu, sem esperar
+    void drain(size_t p)
+    {
+        Partition_reply reply;
+        while (partitions[p]->outbox.try_pop(reply))
+            receive(p, reply);
+    }
+
+    void receive(size_t p, const Partition_reply &reply)
+    {
+        Sync_record &record = sync_records[outstanding[p].front() - first_sync];
+        if (reply.process >= 0)
+        {
+            record.completions.push_back(reply);
+            return;
+        }
+        --record.remaining;
+        outstanding[p].pop();
+        if (outstanding[p].empty())
+            horizon[p] = std::min(reply.time, request_bound[p]);
+    }
+
+    // com a caixa de entrada cheia a partição pode estar parada na de saída: esvazia e tenta de novo
+    void send(size_t p, const Partition_message &message)
+    {
+        while (!partitions[p]->inbox.try_push(message))
+        {
+            drain(p);
+            partitions[p]->inbox.wait_for_space(std::chrono::milliseconds(1));
+        }
+    }
+
+    // pede o avanço das partições que podem ter conclusões até agora e deixa um marcador na fila
+    void synchronize_devices()
+    {
+        bool sent = false;
+        for (size_t p = 0; p < partitions.size(); ++p)
+        {
+            drain(p);
+            // sem a resposta do último avanço o horizonte é desconhecido: avança de novo
+            if (outstanding[p].empty() && horizon[p] > global_time)
+                continue;
+            if (!sent)
+            {
+                sync_records.push_back({global_time, 0, {}});
+                sent = true;
+            }
+            send(p, {PARTITION_ADVANCE, 0, 0, global_time});
+            outstanding[p].push(first_sync + sync_records.size() - 1);
+            ++sync_records.back().remaining;
+            request_bound[p] = INT32_MAX;
+        }
+        if (!sent)
+            return;
+        ++synchronizations;
+        ready_queue.push_back(SYNC_MARKER);
+    }
+
+    // o marcador chegou à frente: espera as respostas do avanço e põe os desbloqueados no lugar dele
+    void resolve_sync()
+    {
+        ready_queue.pop_front();
+        for (size_t p = 0; p < partitions.size(); ++p)
+        {
+            Partition_reply reply;
+            while (!outstanding[p].empty() && outstanding[p].front() == first_sync)
+            {
+                partitions[p]->outbox.pop(reply);
+                receive(p, reply);
+            }
+        }
+
+        Sync_record &record = sync_records.front();
+        std::sort(record.completions.begin(), record.completions.end(),
+                  [this](const Partition_reply &a, const Partition_reply &b)
+                  { return blocked_order[a.process] < blocked_order[b.process]; });
+        for (auto it = record.completions.rbegin(); it != record.completions.rend(); ++it)
+        {
+            Process &proc = processes_list[it->process];
+            proc.is_blocked = false;
+            proc.is_io_pending = false;
+            proc.is_using_io = false;
+            proc.io_end_time = it->time;
+            proc.total_io_time += it->operation_time;
+            proc.is_ready = true;
+            ready_queue.push_front(it->process);
+            account(it->process, record.time);
+        }
+        sync_records.pop_front();
+        ++first_sync;
+    }
+
+    void dispatch()
+    {
+        int index = ready_queue.front();
+        ready_queue.pop_front();
+        Process &process = processes_list[index];
+        process.is_running = true;
+        process.is_ready = false;
+        account(index);
+
+        // sorteios na mesma ordem do IOManager::handle_io
+        int time_advance = 0;
+        if (io_manager.request_io(process))
+        {
+            int slice_used = std::min(cpu_fraction, process.remaining_time);
+            int moment = when_io(slice_used);
+            if (moment > 0 && process.remaining_time - moment > 0)
+            {
+                process.remaining_time -= moment;
+                process.io_start_time = global_time + moment;
+                process.is_running = false;
+                process.is_blocked = true;
+                process.is_io_pending = true;
+                blocked_order[index] = blocked_sequence++;
+                account(index);
+
+                int device = io_manager.choose_device();
+                size_t p = (size_t)device % partitions.size();
+                int bound = process.io_start_time + devices_list[device].operation_time;
+                send(p, {PARTITION_REQUEST, index, device, process.io_start_time});
+                request_bound[p] = std::min(request_bound[p], bound);
+                if (outstanding[p].empty())
+                    horizon[p] = std::min(horizon[p], bound);
+                time_advance = moment;
+            }
+        }
+
+        if (time_advance == 0)
+        {
+            int slice_used = std::min(cpu_fraction, process.remaining_time);
+            process.remaining_time -= slice_used;
+            time_advance = slice_used;
+
+            if (process.remaining_time <= 0)
+            {
+                process.is_finished = true;
+                process.finish_time = global_time + slice_used;
+                process.turnaround_time = process.finish_time - process.creation_time;
+                process.waiting_time = process.turnaround_time - process.execution_time;
+                ++finished_count;
+                account(index);
+                if (summary)
+                    summary->add(process);
+            }
+            else
+            {
+                process.is_running = false;
+                make_ready(index);
+            }
+        }
+
+        global_time += time_advance;
+        synchronize_devices();
+        admit_arrivals();
+    }
+
+    int when_io(int slice_used)
+    {
+        if (slice_used <= 0)
+            return 0;
+        return io_manager.when_request_io(slice_used);
+    }
+
+    // com a CPU ociosa nada muda até a próxima chegada ou conclusão possível de E/S;
+    // a fila vazia não tem marcadores, então todo avanço já foi respondido e os horizontes valem
+    void skip_idle()
+    {
+        int target = next_arrival < arrival_order.size()
+                         ? processes_list[arrival_order[next_arrival]].creation_time
+                         : INT32_MAX;
+        for (int h : horizon)
+            target = std::min(target, h);
+        if (target == INT32_MAX)
+            throw std::runtime_error("Simulacao paralela sem eventos pendentes: processos nunca terminariam");
+
+        global_time = std::max(global_time + 1, target);
+        synchronize_devices();
+        admit_arrivals();
+    }
+};
+
+// vetor alinhado para as cargas vetoriais
+template <typename T, size_t Alignment>
+struct Aligned_allocator
+{
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef Aligned_allocator<U, Alignment> other;
+    };
+
+    Aligned_allocator() {}
+    template <typename U>
+    Aligned_allocator(const Aligned_allocator<U, Alignment> &) {}
+
+    T *allocate(size_t n) { return (T *)::operator new(n * sizeof(T), std::align_val_t(Alignment)); }
+    void deallocate(T *p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+
+    bool operator==(const Aligned_allocator &) const { return true; }
+    bool operator!=(const Aligned_allocator &) const { return false; }
+};
+
+// valor que nunca é página válida; preenche quadros vazios e o padding do vetor
+static const int32_t EMPTY_FRAME = INT32_MIN;
+
+// os quadros são comparados em blocos de 16
+static const size_t FRAME_BLOCK = 16;
+
+// percorre refs enquanto forem acertos e retorna o índice da primeira falta (ou n);
+// frames tem frame_count quadros seguidos de padding EMPTY_FRAME até múltiplo de FRAME_BLOCK
+typedef size_t (*Scan_hits_fn)(const int32_t *frames, size_t frame_count, const int *refs, size_t n);
+
+static size_t scan_hits_scalar(const int32_t *frames, size_t frame_count, const int *refs, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t k = 0;
+        while (k < frame_count && frames[k] != refs[i])
+            k++;
+        if (k == frame_count)
+            return i;
+    }
+    return n;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIFO_HAS_X86_SIMD 1
+
+// lotes de 4 referências comparadas contra cada quadro; o resto passa pela versão escalar
+__attribute__((target("sse2"))) static size_t scan_hits_sse2(const int32_t *frames, size_t frame_count, const int *refs, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i batch = _mm_loadu_si128((const __m128i *)(refs + i));
+        __m128i found = _mm_setzero_si128();
+        for (size_t k = 0; k < frame_count; ++k)
+            found = _mm_or_si128(found, _mm_cmpeq_epi32(batch, _mm_set1_epi32(frames[k])));
+
+        int hits = _mm_movemask_ps(_mm_castsi128_ps(found));
+        if (hits != 0xF)
+            return i + (size_t)__builtin_ctz(~hits);
+    }
+    return i + scan_hits_scalar(frames, frame_count, refs + i, n - i);
+}
+
+// lotes de 8 referências, quadros comparados 16 por vez
+__attribute__((target("avx2"))) static size_t scan_hits_avx2(const int32_t *frames, size_t frame_count, const int *refs, size_t n)
+{
+    size_t padded = (frame_count + FRAME_BLOCK - 1) / FRAME_BLOCK * FRAME_BLOCK;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i batch = _mm256_loadu_si256((const __m256i *)(refs + i));
+        __m256i found_a = _mm256_setzero_si256();
+        __m256i found_b = _mm256_setzero_si256();
+
+        // dois acumuladores; o padding com EMPTY_FRAME deixa ler um quadro a mais
+        for (size_t k = 0; k < frame_count; k += 2)
+        {
+            found_a = _mm256_or_si256(found_a, _mm256_cmpeq_epi32(batch, _mm256_set1_epi32(frames[k])));
+            found_b = _mm256_or_si256(found_b, _mm256_cmpeq_epi32(batch, _mm256_set1_epi32(frames[k + 1])));
+        }
+
+        int hits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(found_a, found_b)));
+        if (hits != 0xFF)
+            return i + (size_t)__builtin_ctz(~hits);
+    }
+
+    // sobra do lote: cada referência contra os quadros em blocos de 16
+    for (; i < n; ++i)
+    {
+        __m256i key = _mm256_set1_epi32(refs[i]);
+        __m256i found = _mm256_setzero_si256();
+        for (size_t k = 0; k < padded; k += FRAME_BLOCK)
+        {
+            const __m256i *block = (const __m256i *)(frames + k);
+            found = _mm256_or_si256(found, _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_load_si256(block), key),
+                                                           _mm256_cmpeq_epi32(_mm256_load_si256(block + 1), key)));
+        }
+        if (_mm256_testz_si256(found, found))
+            return i;
+    }
+    return n;
+}
+#endif
+
+// escolhe a implementação uma vez, conforme a CPU onde está rodando
+static Scan_hits_fn select_scan_hits(const char **isa_name = nullptr)
+{
+    const char *name = "escalar";
+    Scan_hits_fn fn = &scan_hits_scalar;
+#ifdef FIFO_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        name = "AVX2";
+        fn = &scan_hits_avx2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        name = "SSE2";
+        fn = &scan_hits_sse2;
+    }
+#endif
+    if (isa_name)
+        *isa_name = name;
+    return fn;
+}
+
+static const Scan_hits_fn scan_hits = select_scan_hits();
+
+// conjunto de páginas com endereçamento aberto, usado quando há muitos quadros
+class Page_hash_set
+{
+private:
+    std::vector<int32_t> table;
+    uint32_t mask;
+    int shift;
+
+    uint32_t home(int32_t page) const
+    {
+        return ((uint32_t)page * 0x9E3779B1u) >> shift;
+    }
+
+public:
+    Page_hash_set() : mask(0), shift(32) {}
+
+    void reset(int capacity)
+    {
+        int bits = 1;
+        while ((1 << bits) < capacity * 2)
+            bits++;
+        table.assign((size_t)1 << bits, EMPTY_FRAME);
+        mask = (uint32_t)(table.size() - 1);
+        shift = 32 - bits;
+    }
+
+    bool contains(int32_t page) const
+    {
+        for (uint32_t i = home(page);; i = (i + 1) & mask)
+        {
+            if (table[i] == page)
+                return true;
+            if (table[i] == EMPTY_FRAME)
+                return false;
+        }
+    }
+
+    void insert(int32_t page)
+    {
+        uint32_t i = home(page);
+        while (table[i] != EMPTY_FRAME)
+            i = (i + 1) & mask;
+        table[i] = page;
+    }
+
+    // remoção com deslocamento para trás, sem lápides
+    void erase(int32_t page)
+    {
+        uint32_t i = home(page);
+        while (table[i] != page)
+            i = (i + 1) & mask;
+
+        for (uint32_t j = (i + 1) & mask; table[j] != EMPTY_FRAME; j = (j + 1) & mask)
+        {
+            uint32_t k = home(table[j]);
+            bool movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+            if (movable)
+            {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i] = EMPTY_FRAME;
+    }
+};
+
+// motor usado para checar se a página está nos quadros
+enum Fifo_engine
+{
+    FIFO_ENGINE_AUTO,
+    FIFO_ENGINE_SIMD, // varredura vetorial, melhor para poucos quadros
+    FIFO_ENGINE_HASH  // tabela hash, melhor para muitos quadros
+};
+
+// O FIFO esta sendo usado na substituição de páginas
+//
+// os quadros formam um anel: enquanto houver vaga a página entra no próximo quadro livre,
+// depois a vítima é sempre o quadro de next_victim, que avança em ordem de chegada
+class FIFO
+{
+protected:
+    int num_frames;
+    std::vector<int32_t, Aligned_allocator<int32_t, 32>> frames; // com padding até múltiplo de FRAME_BLOCK
+    int used_frames;
+    int next_victim;
+    int page_replacements;
+
+    bool use_simd;
+    Page_hash_set resident; // só no motor por hash
+
+public:
+    // abaixo deste número de quadros a varredura vetorial vence a tabela hash
+    // (cruzamento medido pelo benchmark_fifo_engines: a hash já vence com 24)
+    static const int SIMD_FRAME_LIMIT = 24;
+
+    FIFO(int n_frames, Fifo_engine engine = FIFO_ENGINE_AUTO)
+        : num_frames(n_frames > 0 ? n_frames : 1), used_frames(0), next_victim(0), page_replacements(0)
+    {
+        use_simd = (engine == FIFO_ENGINE_SIMD) || (engine == FIFO_ENGINE_AUTO && num_frames < SIMD_FRAME_LIMIT);
+        size_t padded = ((size_t)num_frames + FRAME_BLOCK - 1) / FRAME_BLOCK * FRAME_BLOCK;
+        frames.assign(padded, EMPTY_FRAME);
+        if (!use_simd)
+            resident.reset(num_frames);
+    }
+
+    int get_page_replacements() const { return page_replacements; }
+    static const char *name() { return "FIFO"; }
+
+protected:
+    bool is_page_in_memory(int page) const
+    {
+        if (use_simd)
+            return scan_hits(frames.data(), (size_t)used_frames, &page, 1) == 1;
+        return resident.contains(page);
+    }
+
+    // coloca a página num quadro livre ou no lugar da mais antiga
+    void load_page(int page)
+    {
+        int slot = used_frames;
+        if (used_frames < num_frames)
+        {
+            used_frames++;
+        }
+        else
+        {
+            slot = next_victim;
+            next_victim = (next_victim + 1) % num_frames;
+            if (!use_simd)
+                resident.erase(frames[slot]);
+            page_replacements++;
+        }
+
+        frames[slot] = page;
+        if (!use_simd)
+            resident.insert(page);
+    }
+
+public:
+    void execute(const std::vector<int> &access_sequence)
+    {
+        execute(access_sequence, 0, access_sequence.size());
+    }
+
+    // executa só o trecho [begin, end) da sequência, permitindo pausar no meio
+    void execute(const std::vector<int> &access_sequence, size_t begin, size_t end)
+    {
+        if (use_simd)
+        {
+            // sequências de acertos ficam inteiras dentro do laço vetorial
+            const int *refs = access_sequence.data();
+            size_t i = begin;
+            while (i < end)
+            {
+                i += scan_hits(frames.data(), (size_t)used_frames, refs + i, end - i);
+                if (i < end)
+                    load_page(refs[i++]);
+            }
+            return;
+        }
+
+        for (size_t i = begin; i < end; ++i)
+            access(access_sequence[i]);
+    }
+
+    // processa uma referência
+    void access(int page)
+    {
+        if (!is_page_in_memory(page))
+            load_page(page);
+    }
+
+    // páginas residentes da mais antiga para a mais nova
+    std::vector<int> arrival_order() const
+    {
+        std::vector<int> pages;
+        int start = (used_frames < num_frames) ? 0 : next_victim;
+        for (int k = 0; k < used_frames; ++k)
+            pages.push_back(frames[(start + k) % num_frames]);
+        return pages;
+    }
+
+    // páginas residentes em ordem de chegada; o anel é reconstruído na carga
+    void save_state(Binary_writer &out) const
+    {
+        std::vector<int> pages = arrival_order();
+        out.put_int(num_frames);
+        out.put_int(page_replacements);
+        out.put_uint(pages.size());
+        for (int page : pages)
+            out.put_int(page);
+    }
+
+    void load_state(Binary_reader &in)
+    {
+        int n_frames = (int)in.get_int();
+        int replacements = (int)in.get_int();
+
+        *this = FIFO(n_frames);
+        page_replacements = replacements;
+        for (uint64_t n = in.get_uint(); n > 0; --n)
+            load_page((int)in.get_int());
+    }
+};
+
+// LRU: substitui a página usada há mais tempo
+class LRU
+{
+protected:
+    int num_frames;
+    std::vector<int> frames; // da menos para a mais recentemente usada
+    int page_replacements;
+
+public:
+    LRU(int n_frames) : num_frames(n_frames), page_replacements(0) {}
+    int get_page_replacements() const { return page_replacements; }
+    static const char *name() { return "LRU"; }
+
+    void execute(const std::vector<int> &access_sequence)
+    {
+        execute(access_sequence, 0, access_sequence.size());
+    }
+
+    void execute(const std::vector<int> &access_sequence, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            access(access_sequence[i]);
+    }
+
+    void access(int page)
+    {
+        auto it = std::find(frames.begin(), frames.end(), page);
+        if (it != frames.end())
+        {
+            // acerto: passa a ser a mais recente
+            std::rotate(it, it + 1, frames.end());
+            return;
+        }
+
+        if (frames.size() >= (size_t)num_frames)
+        {
+            frames.erase(frames.begin());
+            page_replacements++;
+        }
+        frames.push_back(page);
+    }
+
+    void save_state(Binary_writer &out) const
+    {
+        out.put_int(num_frames);
+        out.put_int(page_replacements);
+        out.put_uint(frames.size());
+        for (int page : frames)
+            out.put_int(page);
+    }
+
+    void load_state(Binary_reader &in)
+    {
+        num_frames = (int)in.get_int();
+        page_replacements = (int)in.get_int();
+        frames.clear();
+        for (uint64_t n = in.get_uint(); n > 0; --n)
+            frames.push_back((int)in.get_int());
+    }
+};
+
+// chave de 128 bits de uma simulação de memória: (sequência, política, quadros)
+struct Cache_key
+{
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool operator==(const Cache_key &other) const { return hi == other.hi && lo == other.lo; }
+};
+
+struct Cache_key_hash
+{
+    size_t operator()(const Cache_key &key) const { return (size_t)(key.hi ^ (key.lo * 0x9E3779B97F4A7C15ull)); }
+};
+
+// cache persistente dos resultados de substituição, com despejo LRU
+//
+// arquivo: magic | versão | relógio | n | (hi, lo, trocas, ns, último uso) * n
+class Result_cache
+{
+private:
+    struct Entry
+    {
+        long long replacements = 0;
+        uint64_t simulation_ns = 0; // quanto custou simular, para estimar o tempo economizado
+        uint64_t last_used = 0;
+    };
+
+    std::string path;
+    size_t max_entries;
+    std::unordered_map<Cache_key, Entry, Cache_key_hash> entries;
+    uint64_t clock;
+
+    long long hits;
+    long long misses;
+    uint64_t saved_ns;
+    std::mutex mutex; // compartilhado entre as threads do modo batch
+
+    static const uint64_t VERSION = 1;
+
+public:
+    Result_cache(const std::string &file_path, size_t max_items)
+        : path(file_path), max_entries(max_items > 0 ? max_items : 1), clock(0), hits(0), misses(0), saved_ns(0)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return; // primeira execução, cache vazio
+
+        std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        try
+        {
+            Binary_reader in(bytes);
+            if (in.get_string() != "IOSIMCAC" || in.get_uint() != VERSION)
+                throw std::runtime_error("formato");
+            clock = in.get_uint();
+            for (uint64_t n = in.get_uint(); n > 0; --n)
+            {
+                Cache_key key;
+                key.hi = in.get_uint();
+                key.lo = in.get_uint();
+                Entry entry;
+                entry.replacements = in.get_int();
+                entry.simulation_ns = in.get_uint();
+                entry.last_used = in.get_uint();
+                entries[key] = entry;
+            }
+        }
+        catch (const std::exception &)
+        {
+            // cache corrompido não impede a simulação, só começa vazio
+            std::cerr << "Aviso: cache de resultados '" << path << "' invalido, ignorando\n";
+            entries.clear();
+            clock = 0;
+        }
+    }
+
+    // hash rápido de toda a sequência em duas faixas independentes
+    static Cache_key key_of(const std::vector<int> &trace, const char *policy, int num_frames)
+    {
+        uint64_t a = 0x243F6A8885A308D3ull ^ trace.size();
+        uint64_t b = 0x13198A2E03707344ull;
+        for (int page : trace)
+        {
+            uint64_t v = (uint32_t)page;
+            a = (a ^ v) * 0x9E3779B97F4A7C15ull;
+            a ^= a >> 29;
+            b = (b + v) * 0xC2B2AE3D27D4EB4Full;
+            b = (b << 27) | (b >> 37);
+        }
+        for (const char *c = policy; *c; ++c)
+            a = hash_mix(a, (uint64_t)(unsigned char)*c);
+        b = hash_mix(b, (uint64_t)num_frames);
+
+        Cache_key key;
+        key.hi = hash_mix(a, b);
+        key.lo = hash_mix(b, a ^ 0xA4093822299F31D0ull);
+        return key;
+    }
+
+    bool lookup(const Cache_key &key, long long &replacements)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end())
+        {
+            misses++;
+            return false;
+        }
+        it->second.last_used = ++clock;
+        replacements = it->second.replacements;
+        saved_ns += it->second.simulation_ns;
+        hits++;
+        return true;
+    }
+
+    void store(const Cache_key &key, long long replacements, uint64_t simulation_ns)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = entries[key];
+        entry.replacements = replacements;
+        entry.simulation_ns = simulation_ns;
+        entry.last_used = ++clock;
+    }
+
+    // regrava o arquivo mantendo só as entradas usadas mais recentemente
+    void save()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<std::pair<Cache_key, Entry>> items(entries.begin(), entries.end());
+        if (items.size() > max_entries)
+        {
+            std::nth_element(items.begin(), items.begin() + (long)max_entries, items.end(),
+                             [](const std::pair<Cache_key, Entry> &x, const std::pair<Cache_key, Entry> &y)
+                             { return x.second.last_used > y.second.last_used; });
+            items.resize(max_entries);
+        }
+
+        Binary_writer out;
+        out.put_string("IOSIMCAC");
+        out.put_uint(VERSION);
+        out.put_uint(clock);
+        out.put_uint(items.size());
+        for (const auto &item : items)
+        {
+            out.put_uint(item.first.hi);
+            out.put_uint(item.first.lo);
+            out.put_int(item.second.replacements);
+            out.put_uint(item.second.simulation_ns);
+            out.put_uint(item.second.last_used);
+        }
+
+        std::string tmp_path = path + ".tmp";
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(out.data().data(), (std::streamsize)out.data().size());
+        file.close();
+        if (!file || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+            throw std::runtime_error("Erro ao gravar o cache de resultados: " + path);
+    }
+
+    void print_report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        long long lookups = hits + misses;
+        double hit_rate = lookups > 0 ? 100.0 * (double)hits / (double)lookups : 0.0;
+
+        std::ios::fmtflags flags = out.flags();
+        out << "\n--- Cache de resultados ---\n";
+        out << "Consultas: " << lookups << " | Acertos: " << hits << " | Faltas: " << misses << "\n";
+        out << std::fixed << std::setprecision(2)
+            << "Taxa de acerto do cache: " << hit_rate << "%\n"
+            << "Tempo de simulacao economizado: " << (double)saved_ns / 1e6 << " ms\n";
+        out.flags(flags);
+    }
+};
+
+template <typename Replacement, typename Log>
+class Basic_memory_simulator
+{
+private:
+    Management_Infos config;
+    std::vector<Process> processes;
+    int total_replacements;
+
+    // progresso da simulação, permite pausar e retomar de um checkpoint
+    bool is_local;
+    bool resumed;
+    size_t current_process; // processo em simulação (política local)
+    size_t position;        // próxima referência da sequência atual
+    bool sequence_started;  // a política da sequência atual já foi criada
+    Replacement policy;
+    Checkpoint_manager *checkpoints;
+    std::ostream *log;
+    Result_cache *cache;
+
+    std::vector<int> combined_sequence; // traço da política global
+    std::vector<int> chunk_sequence;    // bloco do traço global no modo em fluxo
+
+    // referências simuladas entre verificações de checkpoint
+    static const size_t CHECKPOINT_CHUNK = 1 << 16;
+
+public:
+    Basic_memory_simulator(const Simulation_data &data)
+        : config(data.management_infos), processes(data.processes), total_replacements(0),
+          is_local(false), resumed(false), current_process(0), position(0), sequence_started(false),
+          policy(1), checkpoints(nullptr), log(&std::cout), cache(nullptr)
+    {
+        std::string mem_policy = config.memory_policy;
+        for (char &c : mem_policy)
+            c = (char)std::tolower(static_cast<unsigned char>(c));
+        is_local = (mem_policy == "local");
+    }
+
+    void run(Checkpoint_manager *checkpoint_manager = nullptr)
+    {
+        checkpoints = checkpoint_manager;
+
+        if (!resumed)
+        {
+            total_replacements = 0;
+            *log << "--- Simulacao de Gerenciamento de Memoria ---\n";
+        }
+
+        if (is_local)
+        {
+            run_local_policy();
+        }
+        else
+        {
+            run_global_policy();
+        }
+
+        *log << "\nTotal " << Replacement::name() << " replacements: " << total_replacements << "\n";
+    }
+
+    int get_total_replacements() const { return total_replacements; }
+    void set_log(std::ostream *stream) { log = stream; }
+    void set_cache(Result_cache *results) { cache = results; }
+
+    // modo em fluxo: os processos chegam em blocos enquanto o arquivo ainda é lido,
+    // com a mesma saída de run()
+    void begin_stream()
+    {
+        total_replacements = 0;
+        *log << "--- Simulacao de Gerenciamento de Memoria ---\n";
+        if (is_local)
+            return;
+
+        // sem cache o traço global é simulado por partes e não precisa ficar inteiro na memória
+        print_global_header(global_frames());
+        if (!cache)
+        {
+            policy = Replacement(global_frames());
+            sequence_started = true;
+        }
+    }
+
+    void stream_processes(const std::vector<Process> &chunk)
+    {
+        if (is_local)
+        {
+            for (const auto &proc : chunk)
+            {
+                simulate_local_process(proc);
+                position = 0;
+                sequence_started = false;
+            }
+            return;
+        }
+
+        std::vector<int> &sequence = cache ? combined_sequence : chunk_sequence;
+        size_t first = sequence.size();
+        append_global_references(chunk, sequence);
+        if (!cache)
+        {
+            policy.execute(sequence, first, sequence.size());
+            sequence.clear();
+        }
+    }
+
+    void end_stream()
+    {
+        if (!is_local)
+        {
+            // o cache é indexado pelo traço completo, então só consulta ao final
+            total_replacements = cache ? (int)simulate_sequence(combined_sequence, global_frames())
+                                       : policy.get_page_replacements();
+            *log << "-> " << Replacement::name() << ": " << total_replacements << " trocas de pagina.\n";
+        }
+
+        *log << "\nTotal " << Replacement::name() << " replacements: " << total_replacements << "\n";
+    }
+
+    void save_state(Binary_writer &out) const
+    {
+        out.put_string(Replacement::name());
+        out.put_uint(is_local ? 1 : 0);
+        out.put_int(total_replacements);
+        out.put_uint(current_process);
+        out.put_uint(position);
+        out.put_uint(sequence_started ? 1 : 0);
+        policy.save_state(out);
+    }
+
+    void load_state(Binary_reader &in)
+    {
+        if (in.get_string() != Replacement::name() || (in.get_uint() != 0) != is_local)
+            throw std::runtime_error("Checkpoint incompativel com o arquivo de entrada");
+        total_replacements = (int)in.get_int();
+        current_process = (size_t)in.get_uint();
+        position = (size_t)in.get_uint();
+        sequence_started = in.get_uint() != 0;
+        policy.load_state(in);
+        resumed = true;
+    }
+
+private:
+    // executa a sequência a partir de position, em blocos, gravando checkpoints entre eles
+    void execute_sequence(const std::vector<int> &sequence)
+    {
+        while (position < sequence.size())
+        {
+            size_t end = std::min(sequence.size(), position + CHECKPOINT_CHUNK);
+            policy.execute(sequence, position, end);
+            position = end;
+
+            if (checkpoints && checkpoints->due())
+            {
+                Binary_writer state;
+                save_state(state);
+                checkpoints->save(CHECKPOINT_MEMORY, state);
+            }
+        }
+    }
+
+    // simula a sequência atual com num_frames quadros, ou reaproveita o resultado do cache
+    long long simulate_sequence(const std::vector<int> &sequence, int num_frames)
+    {
+        Cache_key key;
+        if (cache)
+            key = Result_cache::key_of(sequence, Replacement::name(), num_frames);
+
+        if (!sequence_started)
+        {
+            long long cached = 0;
+            if (cache && cache->lookup(key, cached))
+                return cached;
+
+            policy = Replacement(num_frames);
+            sequence_started = true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        execute_sequence(sequence);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        if (cache)
+            cache->store(key, policy.get_page_replacements(), (uint64_t)elapsed.count());
+        return policy.get_page_replacements();
+    }
+
+    void simulate_local_process(const Process &proc)
+    {
+        // ignora o processo se não tiver sequência de páginas
+        if (proc.page_sequence.empty() || config.page_size <= 0)
+            return;
+
+        int process_virtual_pages = (int)std::ceil((double)proc.memory_needed / (double)config.page_size);
+
+        // número de quadros para este processo 
+        int num_frames = (int)std::floor(process_virtual_pages * (config.allocation_percentage / 100.0));
+
+        // garante ao menos 1 quadro
+        if (num_frames <= 0)
+            num_frames = 1;
+
+        if (Log::enabled && !sequence_started)
+            *log << "\n--- Processo PID: " << proc.pid << " (com " << num_frames << " quadros) ---\n";
+
+        // executa a sequência de acessos e conta as substituições
+        int replacements = (int)simulate_sequence(proc.page_sequence, num_frames);
+        total_replacements += replacements;
+
+        if (Log::enabled)
+            *log << "-> " << Replacement::name() << ": " << replacements << " trocas de pagina.\n";
+    }
+
+    void run_local_policy()
+    {
+        // percorre os processos
+        for (; current_process < processes.size(); ++current_process, position = 0, sequence_started = false)
+            simulate_local_process(processes[current_process]);
+    }
+
+    static void append_global_references(const std::vector<Process> &source, std::vector<int> &sequence)
+    {
+        for (const auto &proc : source)
+        {
+            for (int page : proc.page_sequence)
+                sequence.push_back(proc.pid * 10000 + page);
+        }
+    }
+
+    // calcula o número total de quadros disponíveis
+    int global_frames() const
+    {
+        int total_frames = (config.page_size > 0) ? (config.memory_size / config.page_size) : 1;
+        if (total_frames <= 0)
+            total_frames = 1;
+        return total_frames;
+    }
+
+    void print_global_header(int total_frames)
+    {
+        *log << "\n--- Politica GLOBAL com " << total_frames << " molduras totais ---\n";
+    }
+
+    void run_global_policy()
+    {
+        // constrói sequência combinada de acessos de todos os processos
+        combined_sequence.clear();
+        append_global_references(processes, combined_sequence);
+
+        int total_frames = global_frames();
+        if (!sequence_started)
+            print_global_header(total_frames);
+
+        // atualiza o total de substituições de página
+        total_replacements = (int)simulate_sequence(combined_sequence, total_frames);
+        *log << "-> " << Replacement::name() << ": " << total_replacements << " trocas de pagina.\n";
+    }
+};
+
+using MemorySimulator = Basic_memory_simulator<FIFO, Log_verbose>;
+
+// configuração da TLB e do custo de tradução de endereço
+struct TLB_Config
+{
+    bool enabled = false;
+    int entries = 64;
+    int associativity = 4;
+    bool random_replacement = false; // false = LRU
+    bool use_asid = false;           // false = flush na troca de contexto
+
+    int page_table_levels = 0; // 0 = calcula pelo tamanho do processo
+    int hit_cycles = 1;
+    int level_cycles = 30; // custo de cada acesso à tabela de páginas
+};
+
+// TLB associativa por conjuntos guardada em vetores planos
+class TLB
+{
+private:
+    int num_sets;
+    int ways;
+    uint32_t set_mask;
+    bool random_replacement;
+
+    std::vector<uint64_t> tags;   // (asid << 32) | página, INVALID se vazio
+    std::vector<uint32_t> stamps; // último uso de cada entrada (LRU)
+    uint32_t clock;
+    uint64_t rng_state;
+
+    long long hits;
+    long long misses;
+
+    static constexpr uint64_t INVALID = ~0ull;
+
+    // índice do conjunto misturando página e asid
+    uint32_t set_of(uint64_t key) const
+    {
+        uint64_t h = key * 0x9E3779B97F4A7C15ull;
+        return (uint32_t)(h >> 32) & set_mask;
+    }
+
+    uint32_t next_random()
+    {
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 7;
+        rng_state ^= rng_state << 17;
+        return (uint32_t)rng_state;
+    }
+
+    // evita estouro do relógio do LRU em execuções muito longas
+    void tick()
+    {
+        if (++clock == 0)
+        {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            clock = 1;
+        }
+    }
+
+public:
+    // rejeita a geometria antes de qualquer simulação; o construtor repete a checagem
+    static void check_geometry(int entries, int associativity)
+    {
+        if (entries <= 0 || associativity <= 0 || entries % associativity != 0)
+            throw std::runtime_error("Configuracao de TLB invalida: entradas deve ser multiplo da associatividade");
+
+        int sets = entries / associativity;
+        if ((sets & (sets - 1)) != 0)
+            throw std::runtime_error("Configuracao de TLB invalida: numero de conjuntos deve ser potencia de 2");
+    }
+
+    TLB(int entries, int associativity, bool random_repl)
+        : ways(associativity), random_replacement(random_repl), clock(0),
+          rng_state(0x2545F4914F6CDD1Dull), hits(0), misses(0)
+    {
+        check_geometry(entries, associativity);
+
+        num_sets = entries / associativity;
+        set_mask = (uint32_t)(num_sets - 1);
+        tags.assign((size_t)entries, INVALID);
+        stamps.assign((size_t)entries, 0);
+    }
+
+    // procura a página, instala em caso de falta e retorna se acertou
+    bool access(int asid, int page)
+    {
+        uint64_t key = ((uint64_t)(uint32_t)asid << 32) | (uint32_t)page;
+        size_t base = (size_t)set_of(key) * ways;
+        uint64_t *set_tags = &tags[base];
+        uint32_t *set_stamps = &stamps[base];
+
+        tick();
+
+        int victim = 0;
+        for (int w = 0; w < ways; ++w)
+        {
+            if (set_tags[w] == key)
+            {
+                set_stamps[w] = clock;
+                hits++;
+                return true;
+            }
+            if (set_stamps[w] < set_stamps[victim])
+                victim = w;
+        }
+
+        // prefere uma entrada vazia, senão aplica a política de substituição
+        int empty = -1;
+        for (int w = 0; w < ways; ++w)
+        {
+            if (set_tags[w] == INVALID)
+            {
+                empty = w;
+                break;
+            }
+        }
+        if (empty != -1)
+            victim = empty;
+        else if (random_replacement)
+            victim = (int)(next_random() % (uint32_t)ways);
+
+        set_tags[victim] = key;
+        set_stamps[victim] = clock;
+        misses++;
+        return false;
+    }
+
+    // invalida todas as entradas (troca de contexto sem asid)
+    void flush()
+    {
+        std::fill(tags.begin(), tags.end(), INVALID);
+    }
+
+    long long get_hits() const { return hits; }
+    long long get_misses() const { return misses; }
+};
+
+// simula a tradução de endereços sobre as mesmas referências da memória
+class TranslationSimulator
+{
+private:
+    Management_Infos config;
+    std::vector<Process> processes;
+    TLB_Config tlb_config;
+
+    long long references;
+    long long total_cycles;
+    long long context_switches;
+
+public:
+    TranslationSimulator(const Simulation_data &data, const TLB_Config &tlb_cfg)
+        : config(data.management_infos), processes(data.processes), tlb_config(tlb_cfg),
+          references(0), total_cycles(0), context_switches(0) {}
+
+    // níveis da tabela de páginas necessários para o espaço virtual do processo
+    int page_table_levels(const Process &proc) const
+    {
+        if (tlb_config.page_table_levels > 0)
+            return tlb_config.page_table_levels;
+        if (config.page_size <= 0)
+            return 1;
+
+        long long virtual_pages = (proc.memory_needed + config.page_size - 1) / config.page_size;
+        int page_bits = 0;
+        while ((1ll << page_bits) < virtual_pages)
+            page_bits++;
+
+        // cada tabela ocupa uma página com entradas de 8 bytes
+        int bits_per_level = 0;
+        while ((1 << (bits_per_level + 1)) <= config.page_size / 8)
+            bits_per_level++;
+        if (bits_per_level <= 0)
+            bits_per_level = 1;
+
+        int levels = (page_bits + bits_per_level - 1) / bits_per_level;
+        return levels > 0 ? levels : 1;
+    }
+
+    void run()
+    {
+        TLB tlb(tlb_config.entries, tlb_config.associativity, tlb_config.random_replacement);
+
+        std::vector<int> levels(processes.size());
+        std::vector<size_t> position(processes.size(), 0);
+        for (size_t i = 0; i < processes.size(); ++i)
+            levels[i] = page_table_levels(processes[i]);
+
+        // os processos se alternam na CPU, cada um faz até cpu_fraction referências por vez
+        size_t quantum = config.cpu_fraction > 0 ? (size_t)config.cpu_fraction : 1;
+        int last_pid = -1;
+        bool pending = true;
+
+        references = 0;
+        total_cycles = 0;
+        context_switches = 0;
+
+        while (pending)
+        {
+            pending = false;
+            for (size_t i = 0; i < processes.size(); ++i)
+            {
+                const std::vector<int> &seq = processes[i].page_sequence;
+                if (position[i] >= seq.size())
+                    continue;
+
+                int pid = processes[i].pid;
+                if (pid != last_pid)
+                {
+                    if (last_pid != -1)
+                        context_switches++;
+                    if (!tlb_config.use_asid)
+                        tlb.flush();
+                    last_pid = pid;
+                }
+
+                int asid = tlb_config.use_asid ? pid : 0;
+                long long miss_cycles = (long long)levels[i] * tlb_config.level_cycles;
+                size_t end = std::min(seq.size(), position[i] + quantum);
+
+                for (size_t k = position[i]; k < end; ++k)
+                {
+                    total_cycles += tlb_config.hit_cycles;
+                    if (!tlb.access(asid, seq[k]))
+                        total_cycles += miss_cycles;
+                }
+
+                references += (long long)(end - position[i]);
+                position[i] = end;
+                if (end < seq.size())
+                    pending = true;
+            }
+        }
+
+        long long hits = tlb.get_hits();
+        double hit_rate = references > 0 ? 100.0 * (double)hits / (double)references : 0.0;
+        double cycles_per_ref = references > 0 ? (double)total_cycles / (double)references : 0.0;
+
+        std::cout << "\n--- Simulacao de TLB ---\n";
+        std::cout << "TLB: " << tlb_config.entries << " entradas, " << tlb_config.associativity << " vias, "
+                  << (tlb_config.random_replacement ? "aleatoria" : "LRU") << ", "
+                  << (tlb_config.use_asid ? "ASID" : "flush") << " na troca de contexto\n";
+        std::cout << "Referencias: " << references << " | Acertos: " << hits
+                  << " | Faltas: " << tlb.get_misses() << " | Trocas de contexto: " << context_switches << "\n";
+        std::cout << std::fixed << std::setprecision(2)
+                  << "Taxa de acerto da TLB: " << hit_rate << "%\n"
+                  << "Ciclos estimados por referencia: " << cycles_per_ref << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    }
+};
+
+// responde consultas de "viagem no tempo" lendo o índice de replay
+class Replay_query
+{
+private:
+    std::string path;
+    std::ifstream file;
+    Simulation_data data;
+
+    uint64_t events_count;
+    std::vector<uint64_t> block_offsets;
+    uint64_t by_pid_offset;
+    uint64_t by_pid_count;
+    std::vector<std::pair<int, uint64_t>> pid_ranges;
+    std::vector<Replay_snapshot> snapshots;
+    bool recovered; // sem tabelas finais: histórico por pid varre o log
+
+    void read_raw(uint64_t offset, void *out, size_t size)
+    {
+        file.seekg((std::streamoff)offset);
+        file.read((char *)out, (std::streamsize)size);
+        if (!file)
+            throw std::runtime_error("Indice de replay truncado ou corrompido: " + path);
+    }
+
+    std::string read_bytes(uint64_t offset, uint64_t size)
+    {
+        std::string bytes(size, '\0');
+        if (size > 0)
+            read_raw(offset, &bytes[0], size);
+        return bytes;
+    }
+
+    std::vector<Replay_event> read_events(uint64_t base, uint64_t first, uint64_t count)
+    {
+        std::vector<Replay_event> out(count);
+        if (count > 0)
+            read_raw(base + first * sizeof(Replay_event), out.data(), count * sizeof(Replay_event));
+        return out;
+    }
+
+    // eventos [first, first + count) do log em ordem, atravessando blocos
+    std::vector<Replay_event> read_log_events(uint64_t first, uint64_t count)
+    {
+        std::vector<Replay_event> out;
+        out.reserve(count);
+        while (count > 0)
+        {
+            uint64_t block = first / REPLAY_BLOCK;
+            uint64_t skip = first % REPLAY_BLOCK;
+            uint64_t n = std::min(count, REPLAY_BLOCK - skip);
+            size_t old_size = out.size();
+            out.resize(old_size + n);
+            read_raw(block_offsets[block] + skip * sizeof(Replay_event), &out[old_size], n * sizeof(Replay_event));
+            first += n;
+            count -= n;
+        }
+        return out;
+    }
+
+    void read_tables(uint64_t tables_offset, uint64_t tables_end)
+    {
+        Binary_reader tables(read_bytes(tables_offset, tables_end - tables_offset));
+        events_count = tables.get_uint();
+        for (uint64_t n = tables.get_uint(); n > 0; --n)
+            block_offsets.push_back(tables.get_uint());
+        by_pid_offset = tables.get_uint();
+        by_pid_count = tables.get_uint();
+        for (uint64_t n = tables.get_uint(); n > 0; --n)
+        {
+            int pid = (int)tables.get_int();
+            pid_ranges.push_back({pid, tables.get_uint()});
+        }
+        for (uint64_t n = tables.get_uint(); n > 0; --n)
+        {
+            Replay_snapshot snap;
+            snap.time = (int)tables.get_int();
+            snap.event_index = tables.get_uint();
+            snap.offset = tables.get_uint();
+            snap.size = tables.get_uint();
+            snapshots.push_back(snap);
+        }
+        if (block_offsets.size() != (events_count + REPLAY_BLOCK - 1) / REPLAY_BLOCK)
+            throw std::runtime_error("Indice de replay truncado ou corrompido: " + path);
+    }
+
+    // execução interrompida antes do finish(): reconstrói as tabelas lendo os registros,
+    // até o primeiro registro incompleto
+    void recover_tables(uint64_t position, uint64_t file_size)
+    {
+        recovered = true;
+        events_count = 0;
+        by_pid_offset = 0;
+        by_pid_count = 0;
+        for (;;)
+        {
+            char tag = 0;
+            if (position + 1 > file_size)
+                break;
+            read_raw(position, &tag, 1);
+            position += 1;
+
+            if (tag == RECORD_EVENTS)
+            {
+                uint32_t count = 0;
+                if (position + sizeof(count) > file_size)
+                    break;
+                read_raw(position, &count, sizeof(count));
+                position += sizeof(count);
+                uint64_t bytes = (uint64_t)count * sizeof(Replay_event);
+                // só o último bloco pode estar incompleto
+                if (count == 0 || count > REPLAY_BLOCK || position + bytes > file_size ||
+                    events_count % REPLAY_BLOCK != 0)
+                    break;
+                block_offsets.push_back(position);
+                events_count += count;
+                position += bytes;
+            }
+            else if (tag == RECORD_SNAPSHOT)
+            {
+                int32_t time = 0;
+                uint64_t event_index = 0, size = 0;
+                if (position + sizeof(time) + 2 * sizeof(uint64_t) > file_size)
+                    break;
+                read_raw(position, &time, sizeof(time));
+                read_raw(position + sizeof(time), &event_index, sizeof(event_index));
+                read_raw(position + sizeof(time) + sizeof(event_index), &size, sizeof(size));
+                position += sizeof(time) + 2 * sizeof(uint64_t);
+                if (position + size > file_size)
+                    break;
+                snapshots.push_back({time, event_index, position, size});
+                position += size;
+            }
+            else
+                break;
+        }
+
+        // um snapshot pode apontar para eventos que ficaram no bloco não gravado
+        while (!snapshots.empty() && snapshots.back().event_index > events_count)
+            snapshots.pop_back();
+        std::cerr << "[REPLAY] indice sem tabelas finais (execucao interrompida?); "
+                  << events_count << " eventos e " << snapshots.size() << " snapshots recuperados\n";
+    }
+
+    std::string describe(const Replay_event &ev) const
+    {
+        std::string device;
+        if (ev.device >= 0 && ev.device < (int)data.devices.size())
+            device = data.devices[ev.device].name_id;
+
+        switch (ev.type)
+        {
+        case EVENT_READY:
+            return "entrou na fila de prontos";
+        case EVENT_DISPATCH:
+            return "ganhou a CPU";
+        case EVENT_IO_REQUEST:
+            return "requisitou E/S em " + device;
+        case EVENT_IO_WAIT:
+            return "aguardando " + device;
+        case EVENT_IO_START:
+            return "comecou uso de " + device;
+        case EVENT_IO_END:
+            return "terminou uso de " + device;
+        case EVENT_FINISH:
+            return "finalizou";
+        }
+        return "evento desconhecido";
+    }
+
+public:
+    Replay_query(const std::string &file_path)
+        : path(file_path), file(file_path, std::ios::binary), recovered(false)
+    {
+        if (!file.is_open())
+            throw std::runtime_error("Erro ao abrir o indice de replay: " + file_path);
+
+        char magic[sizeof(REPLAY_MAGIC)];
+        uint64_t header_size = 0;
+        read_raw(0, magic, sizeof(magic));
+        if (!std::equal(magic, magic + sizeof(magic), REPLAY_MAGIC))
+            throw std::runtime_error("Arquivo nao e um indice de replay: " + file_path);
+        read_raw(sizeof(magic), &header_size, sizeof(header_size));
+
+        // reconstrói a carga estática
+        Binary_reader header(read_bytes(sizeof(magic) + sizeof(header_size), header_size));
+        Management_Infos &infos = data.management_infos;
+        infos.scheduling_algorithm = header.get_string();
+        infos.cpu_fraction = (int)header.get_int();
+        infos.memory_policy = header.get_string();
+        infos.memory_size = (int)header.get_int();
+        infos.page_size = (int)header.get_int();
+        for (uint64_t n = header.get_uint(); n > 0; --n)
+        {
+            Device dev;
+            dev.name_id = header.get_string();
+            dev.simultaneous_uses = (int)header.get_int();
+            dev.operation_time = (int)header.get_int();
+            data.devices.push_back(dev);
+        }
+        for (uint64_t n = header.get_uint(); n > 0; --n)
+        {
+            Process proc;
+            proc.pid = (int)header.get_int();
+            proc.creation_time = (int)header.get_int();
+            proc.execution_time = (int)header.get_int();
+            proc.remaining_time = proc.execution_time;
+            proc.priority = (int)header.get_int();
+            proc.memory_needed = (int)header.get_int();
+            proc.io_chance = (int)header.get_int();
+            data.processes.push_back(proc);
+        }
+        infos.num_devices = (int)data.devices.size();
+        infos.num_processes = (int)data.processes.size();
+
+        // tabelas no fim do arquivo, ou reconstrução se a gravação não terminou
+        file.seekg(0, std::ios::end);
+        uint64_t file_size = (uint64_t)file.tellg();
+        uint64_t records_offset = sizeof(magic) + sizeof(header_size) + header_size;
+        char end_magic[sizeof(REPLAY_END_MAGIC)] = {};
+        uint64_t trailer = sizeof(uint64_t) + sizeof(end_magic);
+        if (file_size >= records_offset + trailer)
+            read_raw(file_size - sizeof(end_magic), end_magic, sizeof(end_magic));
+
+        if (std::equal(end_magic, end_magic + sizeof(end_magic), REPLAY_END_MAGIC))
+        {
+            uint64_t tables_offset = 0;
+            read_raw(file_size - trailer, &tables_offset, sizeof(tables_offset));
+            if (tables_offset < records_offset || tables_offset > file_size - trailer)
+                throw std::runtime_error("Indice de replay truncado ou corrompido: " + path);
+            read_tables(tables_offset, file_size - trailer);
+        }
+        else
+            recover_tables(records_offset, file_size);
+
+        if (snapshots.empty())
+            throw std::runtime_error("Indice de replay sem snapshots: " + path);
+    }
+
+    // carrega o snapshot mais próximo antes de t e reexecuta os passos que faltam até t
+    void print_state_at(int time)
+    {
+        auto it = std::upper_bound(snapshots.begin(), snapshots.end(), time,
+                                   [](int t, const Replay_snapshot &snap)
+                                   { return t < snap.time; });
+        if (it != snapshots.begin())
+            --it;
+        const Replay_snapshot &snap = *it;
+
+        // conta no log quantos passos terminam até t depois do snapshot
+        long long steps = 0;
+        const uint64_t block = 4096;
+        bool done = false;
+        for (uint64_t first = snap.event_index; first < events_count && !done; first += block)
+        {
+            std::vector<Replay_event> events = read_log_events(first, std::min(block, events_count - first));
+            for (const Replay_event &ev : events)
+            {
+                if (ev.type != EVENT_STEP)
+                    continue;
+                if (ev.time > time)
+                {
+                    done = true;
+                    break;
+                }
+                steps++;
+            }
+        }
+
+        Basic_round_robin_scheduler<Log_quiet> scheduler(data, 0);
+        Binary_reader state(read_bytes(snap.offset, snap.size));
+        scheduler.load_state(state);
+        for (long long i = 0; i < steps && !scheduler.all_processes_finished(); ++i)
+            scheduler.step();
+
+        std::cout << "Estado reconstruido do snapshot em t=" << snap.time << " + " << steps << " passos\n";
+        scheduler.print_system_state(nullptr);
+    }
+
+    void print_pid_history(int pid)
+    {
+        if (recovered)
+        {
+            print_pid_history_from_log(pid);
+            return;
+        }
+
+        auto it = std::lower_bound(pid_ranges.begin(), pid_ranges.end(), pid,
+                                   [](const std::pair<int, uint64_t> &range, int p)
+                                   { return range.first < p; });
+        if (it == pid_ranges.end() || it->first != pid)
+        {
+            std::cout << "PID " << pid << " nao tem eventos no indice.\n";
+            return;
+        }
+
+        uint64_t first = it->second;
+        uint64_t last = (it + 1 != pid_ranges.end()) ? (it + 1)->second : by_pid_count;
+
+        std::cout << "==================== Historico do PID " << pid << " ====================\n";
+        for (const Replay_event &ev : read_events(by_pid_offset, first, last - first))
+            std::cout << "t=" << ev.time << "\t" << describe(ev) << "\n";
+        std::cout << "====================================================================\n";
+    }
+
+private:
+    // sem a cópia por pid, filtra o log inteiro em blocos
+    void print_pid_history_from_log(int pid)
+    {
+        bool any = false;
+        for (uint64_t first = 0; first < events_count; first += REPLAY_BLOCK)
+        {
+            for (const Replay_event &ev : read_log_events(first, std::min(REPLAY_BLOCK, events_count - first)))
+            {
+                if (ev.type == EVENT_STEP || ev.pid != pid)
+                    continue;
+                if (!any)
+                    std::cout << "==================== Historico do PID " << pid << " ====================\n";
+                any = true;
+                std::cout << "t=" << ev.time << "\t" << describe(ev) << "\n";
+            }
+        }
+        if (any)
+            std::cout << "====================================================================\n";
+        else
+            std::cout << "PID " << pid << " nao tem eventos no indice.\n";
+    }
+};
+
+// opções de linha de comando além do arquivo de entrada
+struct Run_options
+{
+    TLB_Config tlb;
+
+    bool has_seed = false;
+    uint64_t seed = 0;
+
+    std::string checkpoint_path; // grava checkpoints neste arquivo
+    int checkpoint_interval = 60; // segundos entre checkpoints
+    std::string resume_path;      // retoma a partir deste checkpoint
+
+    std::string replay_index_path; // grava o índice de replay durante a simulação
+    int replay_every = 1000;       // passos entre snapshots do índice
+    std::string query_path;        // consulta um índice já gravado
+    int query_time = -1;
+    int query_pid = -1;
+
+    bool batch = false;                   // simula vários arquivos de uma vez
+    std::vector<std::string> batch_inputs; // arquivos ou diretórios do modo batch
+    int threads = 0;                      // 0 = número de núcleos
+    std::string summary_path;             // resumo do batch (.csv ou .json)
+
+    std::string replacement = "fifo"; // política de substituição de páginas
+    bool verbose = true;              // false = só relatórios finais
+    int benchmark_repeats = 0;        // > 0 roda o benchmark de despacho
+
+    std::string cache_path;            // cache persistente de resultados de memória
+    size_t cache_max_entries = 100000; // entradas mantidas no arquivo do cache
+
+    int parallel_workers = 0; // > 0 distribui os dispositivos entre threads
+
+    bool summary_report = false; // percentis em vez da tabela por PID
+
+    bool pipeline = false; // leitura, escalonador e memória ao mesmo tempo
+};
+
+// lê o valor inteiro de uma opção --nome=valor
+static int option_int(const std::string &arg)
+{
+    return std::stoi(arg.substr(arg.find('=') + 1));
+}
+
+Run_options parse_options(int argc, char *argv[], int first)
+{
+    Run_options options;
+
+    for (int i = first; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto starts = [&arg](const char *prefix)
+        { return arg.rfind(prefix, 0) == 0; };
+
+        // qualquer opção de TLB ou tabela de páginas liga a simulação de tradução
+        if (starts("--tlb") || starts("--pt-"))
+            options.tlb.enabled = true;
+
+        if (arg == "--tlb")
+            continue;
+        else if (starts("--tlb-entries="))
+            options.tlb.entries = option_int(arg);
+        else if (starts("--tlb-ways="))
+            options.tlb.associativity = option_int(arg);
+        else if (arg == "--tlb-replacement=lru")
+            options.tlb.random_replacement = false;
+        else if (arg == "--tlb-replacement=random")
+            options.tlb.random_replacement = true;
+        else if (arg == "--tlb-context=flush")
+            options.tlb.use_asid = false;
+        else if (arg == "--tlb-context=asid")
+            options.tlb.use_asid = true;
+        else if (starts("--pt-levels="))
+            options.tlb.page_table_levels = option_int(arg);
+        else if (starts("--tlb-hit-cycles="))
+            options.tlb.hit_cycles = option_int(arg);
+        else if (starts("--pt-level-cycles="))
+            options.tlb.level_cycles = option_int(arg);
+        else if (starts("--seed="))
+        {
+            options.seed = std::stoull(arg.substr(7));
+            options.has_seed = true;
+        }
+        else if (starts("--checkpoint="))
+            options.checkpoint_path = arg.substr(13);
+        else if (starts("--checkpoint-every="))
+            options.checkpoint_interval = option_int(arg);
+        else if (starts("--resume="))
+            options.resume_path = arg.substr(9);
+        else if (starts("--replay-index="))
+            options.replay_index_path = arg.substr(15);
+        else if (starts("--replay-every="))
+            options.replay_every = option_int(arg);
+        else if (starts("--query="))
+            options.query_path = arg.substr(8);
+        else if (starts("--at="))
+            options.query_time = option_int(arg);
+        else if (starts("--pid="))
+            options.query_pid = option_int(arg);
+        else if (arg == "--batch")
+            options.batch = true;
+        else if (starts("--threads="))
+            options.threads = option_int(arg);
+        else if (starts("--summary="))
+            options.summary_path = arg.substr(10);
+        else if (starts("--replacement="))
+            options.replacement = arg.substr(14);
+        else if (arg == "--log=verbose")
+            options.verbose = true;
+        else if (arg == "--log=quiet")
+            options.verbose = false;
+        else if (arg == "--benchmark")
+            options.benchmark_repeats = 100;
+        else if (starts("--benchmark="))
+            options.benchmark_repeats = option_int(arg);
+        else if (starts("--cache="))
+            options.cache_path = arg.substr(8);
+        else if (starts("--cache-max="))
+            options.cache_max_entries = (size_t)std::stoull(arg.substr(12));
+        else if (arg == "--parallel")
+            options.parallel_workers = (int)std::max(1u, std::thread::hardware_concurrency());
+        else if (starts("--parallel="))
+            options.parallel_workers = option_int(arg);
+        else if (arg == "--pipeline")
+            options.pipeline = true;
+        else if (arg == "--report=table")
+            options.summary_report = false;
+        else if (arg == "--report=summary")
+            options.summary_report = true;
+        else if (options.batch && !starts("--"))
+            options.batch_inputs.push_back(arg);
+        else
+            throw std::runtime_error("Opcao desconhecida: " + arg);
+    }
+
+    // a TLB só é montada depois do escalonador e da memória; um erro de geometria tem que aparecer antes
+    if (options.tlb.enabled)
+        TLB::check_geometry(options.tlb.entries, options.tlb.associativity);
+
+    return options;
+}
+
+// modo de consulta: entrada_saida --query=indice [--at=T] [--pid=P]
+int run_replay_query(const Run_options &options)
+{
+    auto start = std::chrono::steady_clock::now();
+    Replay_query query(options.query_path);
+
+    if (options.query_time < 0 && options.query_pid < 0)
+    {
+        std::cout << "erro: informe --at=T e/ou --pid=P para consultar o indice.\n";
+        return 1;
+    }
+    if (options.query_time >= 0)
+        query.print_state_at(options.query_time);
+    if (options.query_pid >= 0)
+        query.print_pid_history(options.query_pid);
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cerr << "[REPLAY] consulta respondida em " << elapsed.count() << " ms\n";
+    return 0;
+}
+
+// fila limitada entre estágios de um pipeline; push bloqueia quando cheia
+template <typename T>
+class Bounded_queue
+{
+private:
+    std::queue<T> items;
+    size_t capacity;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+
+public:
+    explicit Bounded_queue(size_t max_items) : capacity(max_items > 0 ? max_items : 1), closed(false) {}
+
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this]
+                      { return items.size() < capacity || closed; });
+        items.push(std::move(item));
+        not_empty.notify_one();
+    }
+
+    // retorna false quando a fila foi fechada e esvaziada
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this]
+                       { return !items.empty() || closed; });
+        if (items.empty())
+            return false;
+        item = std::move(items.front());
+        items.pop();
+        not_full.notify_one();
+        return true;
+    }
+
+    // avisa os consumidores que não chegarão mais itens
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+};
+
+// métricas finais de um arquivo simulado no modo batch
+struct Batch_result
+{
+    size_t index = 0;
+    std::string file;
+    std::string error;
+
+    int processes = 0;
+    int final_time = 0;
+    double avg_turnaround = 0.0;
+    double avg_ready = 0.0;
+    double avg_blocked = 0.0;
+    double avg_io = 0.0;
+    long long replacements = 0;
+    double elapsed_ms = 0.0;
+
+    std::unique_ptr<Summary_report> summary; // só com --report=summary
+};
+
+struct Batch_job
+{
+    size_t index = 0;
+    std::string file;
+    std::string error;
+    Simulation_data data;
+    std::chrono::steady_clock::time_point start;
+};
+
+// expande diretórios em seus arquivos (em ordem de nome)
+std::vector<std::string> batch_input_files(const std::vector<std::string> &inputs)
+{
+    std::vector<std::string> files;
+    for (const auto &input : inputs)
+    {
+        if (std::filesystem::is_directory(input))
+        {
+            std::vector<std::string> entries;
+            for (const auto &entry : std::filesystem::directory_iterator(input))
+                if (entry.is_regular_file())
+                    entries.push_back(entry.path().string());
+            std::sort(entries.begin(), entries.end());
+            files.insert(files.end(), entries.begin(), entries.end());
+        }
+        else
+            files.push_back(input);
+    }
+    return files;
+}
+
+template <typename Replacement>
+Batch_result simulate_batch_job(Batch_job &job, uint64_t seed, Result_cache *cache, bool with_summary)
+{
+    Batch_result result;
+    result.index = job.index;
+    result.file = job.file;
+    result.error = job.error;
+    if (!result.error.empty())
+        return result;
+
+    std::ostream quiet(nullptr);
+    try
+    {
+        Basic_round_robin_scheduler<Log_quiet> scheduler(job.data, seed);
+        scheduler.set_log(&quiet);
+        if (with_summary)
+        {
+            result.summary.reset(new Summary_report());
+            scheduler.set_summary(result.summary.get());
+        }
+        scheduler.run();
+
+        Basic_memory_simulator<Replacement, Log_quiet> memory_simulator(job.data);
+        memory_simulator.set_log(&quiet);
+        memory_simulator.set_cache(cache);
+        memory_simulator.run();
+
+        const std::vector<Process> &procs = scheduler.get_processes();
+        result.processes = (int)procs.size();
+        result.final_time = scheduler.get_global_time();
+        for (const auto &proc : procs)
+        {
+            result.avg_turnaround += proc.finish_time - proc.creation_time;
+            result.avg_ready += proc.ready_time;
+            result.avg_blocked += proc.blocked_time;
+            result.avg_io += proc.total_io_time;
+        }
+        if (!procs.empty())
+        {
+            result.avg_turnaround /= (double)procs.size();
+            result.avg_ready /= (double)procs.size();
+            result.avg_blocked /= (double)procs.size();
+            result.avg_io /= (double)procs.size();
+        }
+        result.replacements = memory_simulator.get_total_replacements();
+    }
+    catch (const std::exception &e)
+    {
+        result.error = e.what();
+    }
+
+    result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job.start).count();
+    return result;
+}
+
+std::string lowercase(std::string text)
+{
+    for (char &c : text)
+        c = (char)std::tolower(static_cast<unsigned char>(c));
+    return text;
+}
 
-    void print_final_report()
+// escapa aspas, barra e caracteres de controle (\n, \t, \u00XX)
+std::string json_escape(const std::string &text)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    for (char c : text)
     {
-        std::cout << "\n==================== Relatorio final ====================\n";
-        std::cout << std::left << std::setw(6) << "PID"
-                  << std::setw(12) << "Turnaround"
-                  << std::setw(12) << "TempoPronto"
-                  << std::setw(12) << "TempoBloq"
-                  << std::setw(12) << "TotalIO"
-                  << "\n";
-
-        for (auto &proc : processes_list)
+        unsigned char u = (unsigned char)c;
+        if (c == '"' || c == '\\')
+            out += '\\';
+        else if (c == '\n')
         {
-            int turnaround = proc.finish_time - proc.creation_time;
-            std::cout << std::left << std::setw(6) << proc.pid
-                      << std::setw(12) << turnaround
-                      << std::setw(12) << proc.ready_time
-                      << std::setw(12) << proc.blocked_time
-                      << std::setw(12) << proc.total_io_time
-                      << "\n";
+            out += "\\n";
+            continue;
         }
-        std::cout << "=========================================================\n";
-    }
-
-    // atualiza fila de prontos 
-    void update_ready_queue()
-    {
-        for (auto &process : processes_list)
+        else if (c == '\t')
         {
-            if (process.creation_time <= global_time &&
-                !process.is_finished &&
-                !process.is_ready &&
-                !process.is_blocked &&
-                !process.is_running) 
-            {
-                process.is_ready = true;
-                ready_queue.push(&process);
-            }
+            out += "\\t";
+            continue;
+        }
+        else if (u < 0x20)
+        {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 0xf];
+            continue;
         }
+        out += c;
     }
+    return out;
+}
 
-    void run()
+// campo CSV entre aspas; aspas internas são dobradas
+std::string csv_quote(const std::string &text)
+{
+    std::string out = "\"";
+    for (char c : text)
     {
-        // chama a atualização
-        update_ready_queue();
-
-        while (!all_processes_finished())
-        {
-            // escolher próximo processo 
-            if (!ready_queue.empty())
-            {
-                Process *process = ready_queue.front();
-                ready_queue.pop();
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
 
-                process->is_running = true;
-                process->is_ready = false;
+// opções que o batch não repassa às simulações; melhor recusar do que ignorar calado
+static std::string batch_unsupported_option(const Run_options &options)
+{
+    if (options.parallel_workers > 0)
+        return "--parallel";
+    if (options.pipeline)
+        return "--pipeline";
+    if (options.tlb.enabled)
+        return "--tlb/--pt-*";
+    if (!options.checkpoint_path.empty() || !options.resume_path.empty())
+        return "--checkpoint/--resume";
+    if (!options.replay_index_path.empty() || !options.query_path.empty())
+        return "--replay-index/--query";
+    if (options.benchmark_repeats > 0)
+        return "--benchmark";
+    return "";
+}
 
-                print_system_state(process);
+// modo batch: lê, simula e resume vários arquivos em paralelo
+//
+// estágios: leitura -> fila limitada -> simulação -> fila limitada -> relatório (em ordem)
+int run_batch(const Run_options &options)
+{
+    std::string unsupported = batch_unsupported_option(options);
+    if (!unsupported.empty())
+        throw std::runtime_error("--batch nao suporta " + unsupported);
 
-                // chama gerenciador de entrada/saída
-                int time_until_io = io_manager->handle_io(*process, cpu_fraction, global_time);
+    std::vector<std::string> files = batch_input_files(options.batch_inputs);
+    if (files.empty())
+    {
+        std::cout << "erro: nenhum arquivo de entrada para o modo batch.\n";
+        return 1;
+    }
 
-                int time_advance = 0;
+    size_t workers = options.threads > 0 ? (size_t)options.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t readers = std::max<size_t>(1, workers / 2);
+    uint64_t seed = options.has_seed ? options.seed : (uint64_t)std::time(nullptr);
 
-                if (time_until_io > 0)
+    Batch_result (*simulate)(Batch_job &, uint64_t, Result_cache *, bool) = nullptr;
+    std::string replacement = lowercase(options.replacement);
+    if (replacement == "fifo")
+        simulate = &simulate_batch_job<FIFO>;
+    else if (replacement == "lru")
+        simulate = &simulate_batch_job<LRU>;
+    else
+        throw std::runtime_error("Politica de substituicao desconhecida: " + options.replacement);
+
+    // um único cache serve todas as threads: traços repetidos entre arquivos viram acertos
+    std::unique_ptr<Result_cache> cache;
+    if (!options.cache_path.empty())
+        cache.reset(new Result_cache(options.cache_path, options.cache_max_entries));
+
+    // a capacidade limita quantas cargas ficam em memória ao mesmo tempo
+    Bounded_queue<Batch_job> parsed(workers);
+    Bounded_queue<Batch_result> finished(workers * 2);
+    std::atomic<size_t> next_file(0);
+    std::atomic<size_t> readers_left(readers);
+    std::atomic<size_t> workers_left(workers);
+
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (size_t i = next_file++; i < files.size(); i = next_file++)
+            {
+                Batch_job job;
+                job.index = i;
+                job.file = files[i];
+                job.start = std::chrono::steady_clock::now();
+                try
                 {
-                    // o processo requisitou entrada/saída ficando bloqueado
-                    time_advance = time_until_io;
+                    job.data = read_file(files[i]);
                 }
-                else
+                catch (const std::exception &e)
                 {
-                    // não houve entrada/saída continua rodando normal
-                    int slice_used = std::min(cpu_fraction, process->remaining_time);
-                    process->remaining_time -= slice_used;
-                    time_advance = slice_used;
+                    job.error = e.what();
+                }
+                parsed.push(std::move(job));
+            }
+            if (--readers_left == 0)
+                parsed.close(); });
+    }
 
-                    if (process->remaining_time <= 0)
-                    {
-                        process->is_finished = true;
-                        process->finish_time = global_time + slice_used;
-                        process->turnaround_time = process->finish_time - process->creation_time;
-                        process->waiting_time = process->turnaround_time - process->execution_time;
-                        finished_list.push_back(*process);
+    for (size_t w = 0; w < workers; ++w)
+    {
+        threads.emplace_back([&]()
+                             {
+            Batch_job job;
+            while (parsed.pop(job))
+                finished.push(simulate(job, seed, cache.get(), options.summary_report));
+            if (--workers_left == 0)
+                finished.close(); });
+    }
 
-                        std::cout << "[CPU] PID " << process->pid << " finalizou em t=" << process->finish_time << "\n";
-                    }
-                    else
-                    {
-                        // volta para fila de prontos
-                        process->is_running = false;
-                        process->is_ready = true;
-                        ready_queue.push(process);
-                    }
-                }
+    // relatório: escreve cada linha assim que todas as anteriores estiverem prontas
+    std::ofstream summary_file;
+    std::ostream *out = &std::cout;
+    bool json = false;
+    if (!options.summary_path.empty())
+    {
+        summary_file.open(options.summary_path, std::ios::trunc);
+        if (!summary_file.is_open())
+            throw std::runtime_error("Erro ao criar o resumo: " + options.summary_path);
+        out = &summary_file;
+        std::string ext = std::filesystem::path(options.summary_path).extension().string();
+        json = (ext == ".json");
+    }
 
-                // avança o tempo global pelo período consumido 
-                if (time_advance > 0)
-                {
-                    // atualizar contadores por todos os processos pelo tempo avançado
-                    for (auto &proc : processes_list)
-                    {
-                        if (proc.is_blocked)
-                            proc.blocked_time += time_advance;
-                        else if (proc.is_ready && !proc.is_running && !proc.is_finished)
-                            proc.ready_time += time_advance;
-                    }
+    if (json)
+        *out << "[\n";
+    else
+        *out << "arquivo,processos,tempo_final,turnaround_medio,pronto_medio,bloqueado_medio,io_medio,trocas_pagina,tempo_ms,erro\n";
 
-                    global_time += time_advance;
-                }
+    std::vector<Batch_result> pending(files.size());
+    std::vector<bool> ready(files.size(), false);
+    size_t next_to_write = 0;
+    size_t failures = 0;
+    Batch_result result;
+    Summary_report merged; // combinado na ordem dos arquivos, independente das threads
 
-                // após avanço de tempo atualiza estado dos dispositivos
-                io_manager->update_devices(global_time, processes_list);
+    *out << std::fixed << std::setprecision(2);
+    while (finished.pop(result))
+    {
+        size_t index = result.index;
+        pending[index] = std::move(result);
+        ready[index] = true;
 
-                // tira de bloqueado e coloca na fila de prontos
-                for (auto it = blocked_list.begin(); it != blocked_list.end();)
-                {
-                    Process *proc_ptr = *it;
-                    if (!proc_ptr->is_blocked && !proc_ptr->is_running)
-                    {
-                        proc_ptr->is_ready = true;
-                        ready_queue.push(proc_ptr);
-                        it = blocked_list.erase(it);
-                    }
-                    else
-                        ++it;
-                }
+        for (; next_to_write < files.size() && ready[next_to_write]; ++next_to_write)
+        {
+            const Batch_result &r = pending[next_to_write];
+            if (!r.error.empty())
+                failures++;
+            if (r.summary)
+                merged.merge(*r.summary);
 
-                // atualiza fila de prontos
-                update_ready_queue();
+            if (json)
+            {
+                *out << "  {\"arquivo\": \"" << json_escape(r.file) << "\", \"processos\": " << r.processes
+                     << ", \"tempo_final\": " << r.final_time << ", \"turnaround_medio\": " << r.avg_turnaround
+                     << ", \"pronto_medio\": " << r.avg_ready << ", \"bloqueado_medio\": " << r.avg_blocked
+                     << ", \"io_medio\": " << r.avg_io << ", \"trocas_pagina\": " << r.replacements
+                     << ", \"tempo_ms\": " << r.elapsed_ms << ", \"erro\": \"" << json_escape(r.error) << "\"}"
+                     << (next_to_write + 1 < files.size() ? ",\n" : "\n");
             }
             else
             {
-                // CPU ociosa avança tempo até o próximo evento
-                for (auto &proc : processes_list)
-                {
-                    if (proc.is_blocked)
-                        proc.blocked_time++;
-                    else if (proc.is_ready && !proc.is_running && !proc.is_finished)
-                        proc.ready_time++;
-                }
-
-                global_time++;
-                io_manager->update_devices(global_time, processes_list);
-
-                for (auto it = blocked_list.begin(); it != blocked_list.end();)
-                {
-                    Process *proc_ptr = *it;
-                    if (!proc_ptr->is_blocked)
-                    {
-                        proc_ptr->is_ready = true;
-                        ready_queue.push(proc_ptr);
-                        it = blocked_list.erase(it);
-                    }
-                    else
-                        ++it;
-                }
-
-                update_ready_queue();
+                *out << csv_quote(r.file) << "," << r.processes << "," << r.final_time << ","
+                     << r.avg_turnaround << "," << r.avg_ready << "," << r.avg_blocked << ","
+                     << r.avg_io << "," << r.replacements << "," << r.elapsed_ms << "," << csv_quote(r.error) << "\n";
             }
+            pending[next_to_write] = Batch_result(); // libera a memória da linha já escrita
         }
+    }
+    if (json)
+        *out << "]\n";
 
-        print_final_report();
+    for (auto &t : threads)
+        t.join();
+
+    if (options.summary_report)
+        merged.print(std::cout);
+
+    if (cache)
+    {
+        cache->print_report(std::cerr);
+        cache->save();
     }
-};
 
-// O FIFO esta sendo usado na substituição de páginas
-class FIFO
+    std::cerr << "[BATCH] " << files.size() << " arquivos simulados com " << workers << " threads ("
+              << failures << " com erro)\n";
+    return failures == 0 ? 0 : 1;
+}
+
+// fase do escalonador: sequencial, ou paralelo quando pedido e suportado pela carga
+template <template <typename> class Scheduler, typename Log>
+void run_scheduler_phase(Scheduler<Log> &scheduler, const Simulation_data &data, uint64_t seed,
+                         const Run_options &options, Checkpoint_manager *checkpoints, bool recording)
 {
-protected:
-    int num_frames;
-    std::vector<int> frames;
-    std::vector<int> arrival_queue;
-    int page_replacements;
+    std::unique_ptr<Summary_report> summary;
+    if (options.summary_report)
+    {
+        summary.reset(new Summary_report());
+        scheduler.set_summary(summary.get());
+    }
 
-public:
-    FIFO(int n_frames) : num_frames(n_frames), page_replacements(0) {}
-    int get_page_replacements() const { return page_replacements; }
+    std::string unsupported = Parallel_round_robin_scheduler::unsupported_reason(data);
+    if (options.parallel_workers > 0 && unsupported.empty())
+    {
+        if (checkpoints || recording || !options.resume_path.empty())
+            throw std::runtime_error("--parallel nao suporta checkpoint nem indice de replay");
+        if (Log::enabled)
+            std::cerr << "[PARALELO] o modo paralelo imprime apenas o relatorio final\n";
+        Parallel_round_robin_scheduler parallel(data, seed, options.parallel_workers);
+        if (summary)
+            parallel.set_summary(summary.get());
+        parallel.run();
+    }
+    else
+    {
+        if (options.parallel_workers > 0)
+            std::cerr << "[PARALELO] " << unsupported << ", usando o escalonador sequencial\n";
+        scheduler.run(checkpoints);
+    }
+}
 
-protected:
-    bool is_page_in_memory(int page) const
+// simulação completa de uma combinação de políticas; cada combinação é instanciada
+// em tempo de compilação, então os laços internos não têm chamadas virtuais
+template <template <typename> class Scheduler, typename Replacement, typename Log>
+int run_simulation(const Simulation_data &data, const Run_options &options)
+{
+    uint64_t seed = options.has_seed ? options.seed : (uint64_t)std::time(nullptr);
+    Scheduler<Log> scheduler(data, seed);
+    Basic_memory_simulator<Replacement, Log> memory_simulator(data);
+
+    Checkpoint_manager checkpoint_manager(options.checkpoint_path, workload_fingerprint(data),
+                                          options.checkpoint_interval);
+    Checkpoint_manager *checkpoints = nullptr;
+    if (!options.checkpoint_path.empty())
     {
-        for (size_t i = 0; i < frames.size(); ++i)
-        {
-            if (frames[i] == page)
-                return true;
-        }
-        return false;
+        checkpoints = &checkpoint_manager;
+#ifdef SIGUSR1
+        std::signal(SIGUSR1, request_checkpoint);
+#endif
     }
 
-    void replace_page(int page)
+    // ao retomar, restaura a fase em que o checkpoint foi gravado
+    Checkpoint_phase phase = CHECKPOINT_SCHEDULER;
+    if (!options.resume_path.empty())
     {
-        int victim_page = arrival_queue[0];
+        Binary_reader state = Checkpoint_manager::load(options.resume_path, workload_fingerprint(data), phase);
+        if (phase == CHECKPOINT_SCHEDULER)
+            scheduler.load_state(state);
+        else
+            memory_simulator.load_state(state);
+        std::cerr << "[CHECKPOINT] retomando de '" << options.resume_path << "'\n";
+    }
 
-        for (size_t i = 0; i < arrival_queue.size() - 1; ++i)
+    if (phase == CHECKPOINT_SCHEDULER)
+    {
+        std::unique_ptr<Replay_recorder> recorder;
+        if (!options.replay_index_path.empty())
         {
-            arrival_queue[i] = arrival_queue[i + 1];
+            recorder.reset(new Replay_recorder(options.replay_index_path, data, options.replay_every));
+            scheduler.set_recorder(recorder.get());
         }
-        arrival_queue.pop_back();
 
-        for (size_t i = 0; i < frames.size(); ++i)
-        {
-            if (frames[i] == victim_page)
-            {
-                frames.erase(frames.begin() + i);
-                break;
-            }
-        }
+        run_scheduler_phase(scheduler, data, seed, options, checkpoints, recorder != nullptr);
 
-        frames.push_back(page);
-        arrival_queue.push_back(page);
-        page_replacements++;
+        if (recorder)
+            recorder->finish();
     }
 
-public:
-    void execute(const std::vector<int> &access_sequence)
+    std::unique_ptr<Result_cache> cache;
+    if (!options.cache_path.empty())
     {
-        for (int page : access_sequence)
-        {
-            if (!is_page_in_memory(page))
-            {
-                if (frames.size() >= (size_t)num_frames)
-                {
-                    replace_page(page);
-                }
-                else
-                {
-                    frames.push_back(page);
-                    arrival_queue.push_back(page);
-                }
-            }
-        }
+        cache.reset(new Result_cache(options.cache_path, options.cache_max_entries));
+        memory_simulator.set_cache(cache.get());
     }
-};
 
-class MemorySimulator
+    memory_simulator.run(checkpoints);
+
+    if (cache)
+    {
+        cache->print_report(std::cout);
+        cache->save();
+    }
+
+    if (options.tlb.enabled)
+    {
+        TranslationSimulator translation_simulator(data, options.tlb);
+        translation_simulator.run();
+    }
+
+    return 0;
+}
+
+// modo em pipeline: o parser entrega os processos em blocos para o escalonador e para a
+// memória, que rodam em threads próprias. O escalonador só começa depois da leitura: o
+// arquivo não é ordenado por criação, então uma chegada anterior pode estar no fim dele e
+// o tempo total nunca fica abaixo de leitura + escalonador. A memória simula cada bloco
+// assim que chega; sua saída vai para um arquivo temporário e é copiada depois da do
+// escalonador.
+static const size_t PIPELINE_CHUNK = 4096;    // processos por bloco
+static const size_t PIPELINE_QUEUE_CHUNKS = 8; // blocos em trânsito por fila
+
+// arquivo temporário que segura uma saída até a hora de imprimi-la; apagado na destruição
+class Spill_file
 {
 private:
-    Management_Infos config;
-    std::vector<Process> processes;
-    int total_fifo_replacements;
+    std::string path;
 
 public:
-    MemorySimulator(const Simulation_data &data)
-        : config(data.management_infos), processes(data.processes), total_fifo_replacements(0) {}
+    std::ofstream stream;
 
-    void run()
+    explicit Spill_file(const std::string &prefix)
     {
-        std::string mem_policy = config.memory_policy;
-        for (char &c : mem_policy)
-            c = (char)std::tolower(static_cast<unsigned char>(c));
-        bool is_local = (mem_policy == "local");
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        path = (std::filesystem::temp_directory_path() /
+                (prefix + std::to_string(stamp) + "_" + std::to_string((uintptr_t)this) + ".txt"))
+                   .string();
+        stream.open(path, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            throw std::runtime_error("Nao foi possivel criar o arquivo temporario '" + path + "'");
+    }
 
-        total_fifo_replacements = 0;
+    ~Spill_file()
+    {
+        stream.close();
+        std::remove(path.c_str());
+    }
 
-        std::cout << "--- Simulacao de Gerenciamento de Memoria ---\n";
+    void copy_to(std::ostream &out)
+    {
+        stream.close();
+        std::ifstream in(path, std::ios::binary);
+        if (in.peek() != std::ifstream::traits_type::eof())
+            out << in.rdbuf();
+    }
+};
 
-        if (is_local)
+template <template <typename> class Scheduler, typename Replacement, typename Log>
+int run_pipelined_simulation(Workload_reader &reader, const Run_options &options)
+{
+    if (!options.checkpoint_path.empty() || !options.resume_path.empty() || !options.replay_index_path.empty())
+        throw std::runtime_error("--pipeline nao suporta checkpoint nem indice de replay");
+
+    typedef std::shared_ptr<const std::vector<Process>> Process_chunk;
+    typedef std::chrono::steady_clock Clock;
+
+    uint64_t seed = options.has_seed ? options.seed : (uint64_t)std::time(nullptr);
+    auto start = Clock::now();
+
+    Simulation_data data;
+    data.management_infos = reader.get_management_infos();
+    data.devices = reader.get_devices();
+    const Simulation_data header = data;
+
+    std::unique_ptr<Result_cache> cache;
+    if (!options.cache_path.empty())
+        cache.reset(new Result_cache(options.cache_path, options.cache_max_entries));
+
+    Bounded_queue<Process_chunk> to_scheduler(PIPELINE_QUEUE_CHUNKS);
+    Bounded_queue<Process_chunk> to_memory(PIPELINE_QUEUE_CHUNKS);
+    std::atomic<bool> aborted(false); // erro na leitura: as threads descartam o que receberam
+    std::exception_ptr parse_error, scheduler_error, memory_error;
+    double parse_ms = 0.0, scheduler_ms = 0.0, memory_ms = 0.0;
+
+    std::thread scheduler_thread([&]()
+                                 {
+        Process_chunk chunk;
+        try
         {
-            run_local_policy();
+            while (to_scheduler.pop(chunk))
+                data.processes.insert(data.processes.end(), chunk->begin(), chunk->end());
+            if (aborted)
+                return;
+
+            auto began = Clock::now();
+            data.management_infos.num_processes = (int)data.processes.size();
+            Scheduler<Log> scheduler(data, seed);
+            run_scheduler_phase(scheduler, data, seed, options, nullptr, false);
+            scheduler_ms = std::chrono::duration<double, std::milli>(Clock::now() - began).count();
         }
-        else
+        catch (...)
         {
-            run_global_policy();
+            scheduler_error = std::current_exception();
+            while (to_scheduler.pop(chunk))
+            {
+            }
+        } });
+
+    Spill_file memory_output("iosim_memoria_");
+    std::thread memory_thread([&]()
+                              {
+        Process_chunk chunk;
+        try
+        {
+            auto began = Clock::now();
+            Basic_memory_simulator<Replacement, Log> memory_simulator(header);
+            memory_simulator.set_log(&memory_output.stream);
+            memory_simulator.set_cache(cache.get());
+            memory_simulator.begin_stream();
+            while (to_memory.pop(chunk))
+                memory_simulator.stream_processes(*chunk);
+            if (aborted)
+                return;
+            memory_simulator.end_stream();
+            memory_ms = std::chrono::duration<double, std::milli>(Clock::now() - began).count();
         }
+        catch (...)
+        {
+            memory_error = std::current_exception();
+            while (to_memory.pop(chunk))
+            {
+            }
+        } });
 
-        std::cout << "\nTotal FIFO replacements: " << total_fifo_replacements << "\n";
+    try
+    {
+        for (;;)
+        {
+            std::shared_ptr<std::vector<Process>> chunk(new std::vector<Process>());
+            if (reader.read_processes(*chunk, PIPELINE_CHUNK) == 0)
+                break;
+            to_scheduler.push(chunk);
+            to_memory.push(chunk);
+        }
     }
+    catch (...)
+    {
+        parse_error = std::current_exception();
+        aborted = true;
+    }
+    parse_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    to_scheduler.close();
+    to_memory.close();
 
-    int get_total_replacements() const { return total_fifo_replacements; }
-
-private:
-    void run_local_policy()
+    scheduler_thread.join();
+    memory_thread.join();
+    for (const std::exception_ptr &error : {parse_error, scheduler_error, memory_error})
     {
-        // percorre os processos
-        for (const auto &proc : processes)
-        {
-            // ignora o processo se não tiver sequência de páginas
-            if (proc.page_sequence.empty() || config.page_size <= 0)
-                continue;
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    memory_output.copy_to(std::cout);
 
-            int process_virtual_pages = (int)std::ceil((double)proc.memory_needed / (double)config.page_size);
+    if (cache)
+    {
+        cache->print_report(std::cout);
+        cache->save();
+    }
 
-            // número de quadros para este processo 
-            int num_frames = (int)std::floor(process_virtual_pages * (config.allocation_percentage / 100.0));
+    if (options.tlb.enabled)
+    {
+        TranslationSimulator translation_simulator(data, options.tlb);
+        translation_simulator.run();
+    }
 
-            // garante ao menos 1 quadro
-            if (num_frames <= 0)
-                num_frames = 1;
+    double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cerr << "[PIPELINE] leitura " << parse_ms << " ms, escalonador " << scheduler_ms
+              << " ms, memoria " << memory_ms << " ms, total " << total_ms << " ms\n";
+    return 0;
+}
 
-            std::cout << "\n--- Processo PID: " << proc.pid << " (com " << num_frames << " quadros) ---\n";
+typedef int (*Simulation_entry)(const Simulation_data &, const Run_options &);
+typedef int (*Pipeline_entry)(Workload_reader &, const Run_options &);
 
-            
-            FIFO fifo(num_frames);
+// tabela que liga os nomes das políticas às instanciações
+struct Simulation_variant
+{
+    const char *scheduling;
+    const char *replacement;
+    bool verbose;
+    Simulation_entry run;
+    Pipeline_entry pipelined;
+};
 
-            // executa a sequência de acessos 
-            fifo.execute(proc.page_sequence);
+static const Simulation_variant simulation_variants[] = {
+    {"alternancia", "fifo", true, &run_simulation<Basic_round_robin_scheduler, FIFO, Log_verbose>,
+     &run_pipelined_simulation<Basic_round_robin_scheduler, FIFO, Log_verbose>},
+    {"alternancia", "fifo", false, &run_simulation<Basic_round_robin_scheduler, FIFO, Log_quiet>,
+     &run_pipelined_simulation<Basic_round_robin_scheduler, FIFO, Log_quiet>},
+    {"alternancia", "lru", true, &run_simulation<Basic_round_robin_scheduler, LRU, Log_verbose>,
+     &run_pipelined_simulation<Basic_round_robin_scheduler, LRU, Log_verbose>},
+    {"alternancia", "lru", false, &run_simulation<Basic_round_robin_scheduler, LRU, Log_quiet>,
+     &run_pipelined_simulation<Basic_round_robin_scheduler, LRU, Log_quiet>},
+};
 
-            // número de substituições
-            int fifo_reps = fifo.get_page_replacements();
-            total_fifo_replacements += fifo_reps;
+// nomes aceitos no campo de algoritmo do arquivo de entrada
+std::string scheduling_policy_name(const std::string &algorithm)
+{
+    std::string name = lowercase(algorithm);
+    if (name == "alternancia" || name == "rr" || name == "round_robin" || name == "round-robin" || name == "roundrobin")
+        return "alternancia";
+    return "";
+}
 
-            std::cout << "-> FIFO: " << fifo_reps << " trocas de pagina.\n";
-        }
+const Simulation_variant &find_simulation(const std::string &algorithm, const std::string &replacement, bool verbose)
+{
+    std::string scheduling = scheduling_policy_name(algorithm);
+    if (scheduling.empty())
+    {
+        // o campo era ignorado antes, então algoritmos desconhecidos continuam rodando em alternância
+        std::cerr << "Aviso: algoritmo de escalonamento '" << algorithm << "' desconhecido, usando alternancia\n";
+        scheduling = "alternancia";
     }
 
-    void run_global_policy()
+    for (const auto &variant : simulation_variants)
     {
-        // constrói sequência combinada de acessos de todos os processos
-        std::vector<int> combined_sequence;
+        if (scheduling == variant.scheduling && lowercase(replacement) == variant.replacement && verbose == variant.verbose)
+            return variant;
+    }
+    throw std::runtime_error("Politica de substituicao desconhecida: " + replacement);
+}
 
-       
-        for (const auto &proc : processes)
-        {
-            for (int page : proc.page_sequence)
-                combined_sequence.push_back(proc.pid * 10000 + page);
-        }
+// interface virtual usada só como base de comparação no benchmark
+class Replacement_interface
+{
+public:
+    virtual ~Replacement_interface() {}
+    virtual void access(int page) = 0;
+    virtual int get_page_replacements() const = 0;
+};
 
-        // calcula o número total de quadros disponíveis
-        int total_frames = (config.page_size > 0) ? (config.memory_size / config.page_size) : 1;
-        if (total_frames <= 0)
-            total_frames = 1;
+template <typename Replacement>
+class Virtual_replacement : public Replacement_interface
+{
+private:
+    Replacement policy;
 
-       
-        std::cout << "\n--- Politica GLOBAL com " << total_frames << " molduras totais ---\n";
+public:
+    Virtual_replacement(int n_frames) : policy(n_frames) {}
+    void access(int page) override { policy.access(page); }
+    int get_page_replacements() const override { return policy.get_page_replacements(); }
+};
 
-        FIFO fifo(total_frames);
+// escolhida pelo nome em tempo de execução para o compilador não conseguir desvirtualizar
+std::unique_ptr<Replacement_interface> make_virtual_replacement(const std::string &name, int n_frames)
+{
+    if (name == "lru")
+        return std::unique_ptr<Replacement_interface>(new Virtual_replacement<LRU>(n_frames));
+    return std::unique_ptr<Replacement_interface>(new Virtual_replacement<FIFO>(n_frames));
+}
 
-        fifo.execute(combined_sequence);
+template <typename Replacement>
+void benchmark_replacement(const std::vector<int> &sequence, int n_frames)
+{
+    using clock = std::chrono::steady_clock;
+
+    // os dois lados passam por access() a cada referência, então a razão mede só o custo
+    // da chamada virtual (execute() do FIFO agrupa referências no caminho vetorial)
+    auto start = clock::now();
+    Replacement templated(n_frames);
+    for (int page : sequence)
+        templated.access(page);
+    double templated_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    std::string name = lowercase(Replacement::name());
+    start = clock::now();
+    std::unique_ptr<Replacement_interface> dynamic = make_virtual_replacement(name, n_frames);
+    for (int page : sequence)
+        dynamic->access(page);
+    double virtual_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    double refs = sequence.empty() ? 1.0 : (double)sequence.size();
+    std::cout << std::left << std::setw(6) << Replacement::name()
+              << std::setw(9) << n_frames
+              << std::setw(14) << templated_ns / refs
+              << std::setw(14) << virtual_ns / refs
+              << std::setw(10) << virtual_ns / templated_ns
+              << (templated.get_page_replacements() == dynamic->get_page_replacements() ? "ok" : "DIFERENTE")
+              << "\n";
+}
 
-        // atualiza o total de substituições de página
-        total_fifo_replacements = fifo.get_page_replacements();
-        std::cout << "-> FIFO: " << total_fifo_replacements << " trocas de pagina.\n";
+// tempo por referência de um motor do FIFO sobre a sequência
+double time_fifo_engine(const std::vector<int> &sequence, int n_frames, Fifo_engine engine, int &replacements)
+{
+    // melhor de três execuções para reduzir ruído
+    double best = 0.0;
+    for (int round = 0; round < 3; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        FIFO fifo(n_frames, engine);
+        fifo.execute(sequence);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        replacements = fifo.get_page_replacements();
+        if (round == 0 || ns < best)
+            best = ns;
     }
-};
+    return sequence.empty() ? 0.0 : best / (double)sequence.size();
+}
+
+// mede em que número de quadros a tabela hash passa a vencer a varredura vetorial
+void benchmark_fifo_engines()
+{
+    const char *isa = nullptr;
+    select_scan_hits(&isa);
+    std::cout << "--- Benchmark: FIFO vetorial (" << isa << ") x hash ---\n";
+    std::cout << std::left << std::setw(9) << "Quadros" << std::setw(14) << "ns/ref simd"
+              << std::setw(14) << "ns/ref hash" << "resultado\n";
+
+    // conjunto de trabalho um pouco maior que os quadros: maioria de acertos com algumas faltas
+    const size_t references = 2000000;
+    int crossover = -1;
+    for (int n_frames : {4, 8, 16, 24, 32, 48, 64, 96, 128, 192, 256})
+    {
+        Sim_random random((uint64_t)n_frames);
+        uint32_t working_set = (uint32_t)(n_frames + n_frames / 16 + 1);
+        std::vector<int> sequence(references);
+        for (int &page : sequence)
+            page = (int)(random.next() % working_set);
+
+        int simd_reps = 0, hash_reps = 0;
+        double simd_ns = time_fifo_engine(sequence, n_frames, FIFO_ENGINE_SIMD, simd_reps);
+        double hash_ns = time_fifo_engine(sequence, n_frames, FIFO_ENGINE_HASH, hash_reps);
+        if (crossover < 0 && hash_ns < simd_ns)
+            crossover = n_frames;
+
+        std::cout << std::left << std::setw(9) << n_frames << std::setw(14) << simd_ns
+                  << std::setw(14) << hash_ns << (simd_reps == hash_reps ? "ok" : "DIFERENTE") << "\n";
+    }
+
+    if (crossover > 0)
+        std::cout << "Hash passa a vencer a partir de " << crossover << " quadros (limite atual: "
+                  << FIFO::SIMD_FRAME_LIMIT << ")\n";
+    else
+        std::cout << "Varredura vetorial venceu em todos os tamanhos (limite atual: " << FIFO::SIMD_FRAME_LIMIT << ")\n";
+}
+
+// compara os núcleos instanciados por template com uma chamada virtual por referência
+int run_dispatch_benchmark(const Simulation_data &data, int repeats)
+{
+    std::vector<int> sequence;
+    for (int r = 0; r < repeats; ++r)
+        for (const auto &proc : data.processes)
+            for (int page : proc.page_sequence)
+                sequence.push_back(proc.pid * 10000 + page);
+
+    // poucos quadros expõem o custo do despacho; muitos quadros são dominados pela busca
+    const Management_Infos &config = data.management_infos;
+    int global_frames = (config.page_size > 0) ? (config.memory_size / config.page_size) : 1;
+    std::vector<int> frame_counts = {4, 16, 64};
+    if (global_frames > 64)
+        frame_counts.push_back(global_frames);
+
+    std::cout << "--- Benchmark: template x virtual (" << sequence.size() << " referencias) ---\n";
+    std::cout << std::left << std::setw(6) << "Pol." << std::setw(9) << "Quadros" << std::setw(14) << "ns/ref tmpl"
+              << std::setw(14) << "ns/ref virt" << std::setw(10) << "razao" << "resultado\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (int n_frames : frame_counts)
+    {
+        benchmark_replacement<FIFO>(sequence, n_frames);
+        benchmark_replacement<LRU>(sequence, n_frames);
+    }
+
+    benchmark_fifo_engines();
+    return 0;
+}
 
 // estou passando os valores pelo terminal cansei de editar no vs code (Lucas te vira e aprende a usar terminal)
 int main(int argc, char *argv[])
 {
     std::string file_name;
     
-    
+    // consulta a um índice de replay e modo batch não usam um único arquivo de entrada
+    if (argc > 1 && (std::string(argv[1]).rfind("--query=", 0) == 0 || std::string(argv[1]) == "--batch"))
+    {
+        try
+        {
+            Run_options options = parse_options(argc, argv, 1);
+            return options.batch ? run_batch(options) : run_replay_query(options);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Erro: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     if (argc > 1)
     {
         file_name = argv[1];
@@ -862,18 +4762,27 @@ int main(int argc, char *argv[])
 
     try
     {
+        Run_options options = parse_options(argc, argv, 2);
+        if (options.pipeline && options.benchmark_repeats == 0)
+        {
+            Workload_reader reader(file_name);
+            const Simulation_variant &variant = find_simulation(reader.get_management_infos().scheduling_algorithm,
+                                                                options.replacement, options.verbose);
+            return variant.pipelined(reader, options);
+        }
+
         Simulation_data data = read_file(file_name);
 
-        RoundRobinScheduler scheduler(data);
-        scheduler.run();
+        if (options.benchmark_repeats > 0)
+            return run_dispatch_benchmark(data, options.benchmark_repeats);
 
-        MemorySimulator memory_simulator(data);
-        memory_simulator.run();
+        const Simulation_variant &variant = find_simulation(data.management_infos.scheduling_algorithm,
+                                                            options.replacement, options.verbose);
+        return variant.run(data, options);
     }
     catch (const std::exception &e)
     {
         std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
     }
-
-    return 0;
 }